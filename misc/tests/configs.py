@@ -132,6 +132,19 @@ def configs_optimal_extended():
         "pdb": [
             "--search",
             "astar(pdb())"],
+        "astar_symbolic_pdb": [
+            "--search",
+            "astar(symbolic_pdb())"],
+        "astar_cpdbs_systematic_streaming": [
+            "--search",
+            "astar(cpdbs(systematic(2,streaming=true)))"],
+        "astar_blind_delayed_duplicate_detection": [
+            "--search",
+            "astar(blind(),delayed_duplicate_detection=100)"],
+        "astar_lmcut_disk": [
+            "--search",
+            "astar(lmcut(),state_storage=disk,"
+            "delayed_duplicate_detection=100)"],
     }
 
 
@@ -148,6 +161,11 @@ def configs_satisficing_extended():
         "eager_greedy_ff_no_pref": [
             "--search",
             "eager_greedy([ff()])"],
+        "eager_greedy_add_incremental": [
+            "--evaluator",
+            "h=add(incremental=true)",
+            "--search",
+            "eager_greedy([h],preferred=[h])"],
         # lazy greedy
         "lazy_greedy_alt_cea_cg": [
             "--evaluator",
@@ -176,6 +194,9 @@ def configs_satisficing_extended():
             "h=cg()",
             "--search",
             "eager(single(sum([g(),weight(h,3)])),preferred=[h])"],
+        "eager_wa3_cpdbs": [
+            "--search",
+            "eager(single(sum([g(),weight(cpdbs(),3)])))"],
         # ehc
         "ehc_ff": [
             "--search",
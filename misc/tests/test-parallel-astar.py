@@ -0,0 +1,47 @@
+import os
+import re
+import subprocess
+import sys
+
+import pytest
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "misc", "tests", "benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+
+TASKS = [
+    "gripper/prob01.pddl",
+    "miconic/s1-0.pddl",
+    "miconic-simpleadl/s1-0.pddl",
+]
+
+HEURISTICS = ["blind()", "hmax()"]
+
+THREADS = [1, 2, 4]
+
+
+def get_plan_cost(task, search):
+    cmd = [sys.executable, FAST_DOWNWARD, "--plan-file", os.devnull,
+           os.path.join(BENCHMARKS_DIR, task), "--search", search]
+    print("\nRun: {}".format(" ".join(cmd)))
+    output = subprocess.check_output(cmd, cwd=REPO).decode()
+    match = re.search(r"Plan cost: (\d+)", output)
+    assert match, output
+    return int(match.group(1))
+
+
+@pytest.mark.parametrize("task", TASKS)
+@pytest.mark.parametrize("heuristic", HEURISTICS)
+def test_parallel_astar_finds_optimal_plans(task, heuristic):
+    optimal_cost = get_plan_cost(task, "astar({})".format(heuristic))
+    for threads in THREADS:
+        search = "parallel_astar({}, threads={})".format(heuristic, threads)
+        assert get_plan_cost(task, search) == optimal_cost
+
+
+@pytest.mark.parametrize("task", TASKS)
+def test_parallel_astar_with_disk_storage(task):
+    optimal_cost = get_plan_cost(task, "astar(blind())")
+    search = "parallel_astar(blind(), threads=2, state_storage=disk)"
+    assert get_plan_cost(task, search) == optimal_cost
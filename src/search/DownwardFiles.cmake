@@ -51,6 +51,7 @@ fast_downward_plugin(
         abstract_task
         axioms
         command_line
+        effect_programs
         evaluation_context
         evaluation_result
         evaluator
@@ -110,12 +111,14 @@ fast_downward_plugin(
         utils/collections
         utils/countdown_timer
         utils/exceptions
+        utils/file_backed_arena
         utils/hash
         utils/language
         utils/logging
         utils/markup
         utils/math
         utils/memory
+        utils/parallel
         utils/rng
         utils/rng_options
         utils/strings
@@ -168,6 +171,14 @@ fast_downward_plugin(
         open_lists/type_based_open_list
 )
 
+fast_downward_plugin(
+    NAME DECISION_DIAGRAMS
+    HELP "Reduced ordered decision diagrams with integer terminals"
+    SOURCES
+        algorithms/decision_diagrams
+    DEPENDENCY_ONLY
+)
+
 fast_downward_plugin(
     NAME DYNAMIC_BITSET
     HELP "Poor man's version of boost::dynamic_bitset"
@@ -441,6 +452,14 @@ fast_downward_plugin(
         search_engines/iterated_search
 )
 
+fast_downward_plugin(
+    NAME PARALLEL_ASTAR_SEARCH
+    HELP "Hash-distributed parallel A* search"
+    SOURCES
+        search_engines/parallel_astar_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME LAZY_SEARCH
     HELP "Lazy search algorithm"
@@ -721,10 +740,12 @@ fast_downward_plugin(
         pdbs/canonical_pdbs
         pdbs/canonical_pdbs_heuristic
         pdbs/cegar
+        pdbs/distance_table
         pdbs/dominance_pruning
         pdbs/incremental_canonical_pdbs
         pdbs/match_tree
         pdbs/max_cliques
+        pdbs/packed_hash_plan
         pdbs/pattern_cliques
         pdbs/pattern_collection_information
         pdbs/pattern_collection_generator_combo
@@ -739,14 +760,17 @@ fast_downward_plugin(
         pdbs/pattern_generator_manual
         pdbs/pattern_generator
         pdbs/pattern_information
+        pdbs/pdb_cache
         pdbs/pdb_heuristic
         pdbs/plugin_group
+        pdbs/symbolic_pattern_database
+        pdbs/symbolic_pdb_heuristic
         pdbs/types
         pdbs/utils
         pdbs/validation
         pdbs/zero_one_pdbs
         pdbs/zero_one_pdbs_heuristic
-    DEPENDS CAUSAL_GRAPH MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
+    DEPENDS CAUSAL_GRAPH DECISION_DIAGRAMS DYNAMIC_BITSET MAX_CLIQUES PRIORITY_QUEUES SAMPLING SUCCESSOR_GENERATOR TASK_PROPERTIES VARIABLE_ORDER_FINDER
 )
 
 fast_downward_plugin(
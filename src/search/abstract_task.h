@@ -105,6 +105,16 @@ public:
     virtual void convert_ancestor_state_values(
         std::vector<int> &values,
         const AbstractTask *ancestor_task) const = 0;
+
+    /*
+      Return true iff convert_ancestor_state_values leaves the values of
+      all states of the ancestor task unchanged. In this case, the
+      (packed) data of an ancestor state can be read as the data of the
+      converted state. Task A has to be an ancestor of this task (see
+      above).
+    */
+    virtual bool keeps_ancestor_state_values(
+        const AbstractTask *ancestor_task) const = 0;
 };
 
 #endif
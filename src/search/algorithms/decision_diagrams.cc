@@ -0,0 +1,334 @@
+#include "decision_diagrams.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace decision_diagrams {
+static const size_t MIN_UNIQUE_TABLE_SIZE = 1 << 16;
+
+enum Operation {
+    AND,
+    OR,
+    NOT,
+    IF_THEN_ELSE,
+    RESTRICT
+};
+
+const NodeID DDManager::FALSE_NODE;
+const NodeID DDManager::TRUE_NODE;
+
+DDManager::DDManager(int num_variables)
+    : num_variables(num_variables) {
+    assert(num_variables >= 0);
+    resize_tables(MIN_UNIQUE_TABLE_SIZE);
+    // The first two nodes are the terminals FALSE_NODE and TRUE_NODE.
+    get_terminal(0);
+    get_terminal(1);
+    assert(nodes[FALSE_NODE].low == 0 && nodes[TRUE_NODE].low == 1);
+}
+
+uint64_t DDManager::hash(int a, int b, int c, int d) {
+    uint64_t h = static_cast<uint32_t>(a);
+    h = h * 0x9e3779b97f4a7c15ULL + static_cast<uint32_t>(b);
+    h = h * 0x9e3779b97f4a7c15ULL + static_cast<uint32_t>(c);
+    h = h * 0x9e3779b97f4a7c15ULL + static_cast<uint32_t>(d);
+    h ^= h >> 31;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 29;
+    return h;
+}
+
+void DDManager::resize_tables(size_t unique_table_size) {
+    unique_table.assign(unique_table_size, -1);
+    size_t mask = unique_table_size - 1;
+    for (size_t id = 0; id < nodes.size(); ++id) {
+        const Node &node = nodes[id];
+        size_t slot = hash(node.var, node.low, node.high, 0) & mask;
+        while (unique_table[slot] != -1) {
+            slot = (slot + 1) & mask;
+        }
+        unique_table[slot] = id;
+    }
+    // Stored results may refer to renumbered nodes, so we start anew.
+    cache.assign(unique_table_size / 4, CacheEntry {-1, 0, 0, 0, 0});
+}
+
+NodeID DDManager::find_or_insert(int var, NodeID low, NodeID high) {
+    size_t mask = unique_table.size() - 1;
+    size_t slot = hash(var, low, high, 0) & mask;
+    while (unique_table[slot] != -1) {
+        const Node &node = nodes[unique_table[slot]];
+        if (node.var == var && node.low == low && node.high == high) {
+            return unique_table[slot];
+        }
+        slot = (slot + 1) & mask;
+    }
+    NodeID id = nodes.size();
+    nodes.push_back(Node {var, low, high});
+    unique_table[slot] = id;
+    // Keep the load factor of the unique table at most 1/2.
+    if (nodes.size() * 2 > unique_table.size()) {
+        resize_tables(unique_table.size() * 2);
+    }
+    return id;
+}
+
+NodeID DDManager::make_node(int var, NodeID low, NodeID high) {
+    assert(var < num_variables);
+    assert(nodes[low].var > var && nodes[high].var > var);
+    if (low == high) {
+        return low;
+    }
+    return find_or_insert(var, low, high);
+}
+
+bool DDManager::lookup_cache(
+    int operation, NodeID first, NodeID second, NodeID third,
+    NodeID &result) const {
+    const CacheEntry &entry =
+        cache[hash(operation, first, second, third) & (cache.size() - 1)];
+    if (entry.operation == operation && entry.first == first &&
+        entry.second == second && entry.third == third) {
+        result = entry.result;
+        return true;
+    }
+    return false;
+}
+
+void DDManager::insert_cache(
+    int operation, NodeID first, NodeID second, NodeID third,
+    NodeID result) {
+    cache[hash(operation, first, second, third) & (cache.size() - 1)] =
+        CacheEntry {operation, first, second, third, result};
+}
+
+int DDManager::get_top_variable(NodeID first, NodeID second) const {
+    return min(nodes[first].var, nodes[second].var);
+}
+
+NodeID DDManager::get_cofactor(NodeID node, int var, bool value) const {
+    const Node &n = nodes[node];
+    if (n.var != var) {
+        // The node does not depend on var.
+        return node;
+    }
+    return value ? n.high : n.low;
+}
+
+NodeID DDManager::get_terminal(int value) {
+    return find_or_insert(num_variables, value, 0);
+}
+
+NodeID DDManager::make_cube(const vector<int> &assignment) {
+    assert(static_cast<int>(assignment.size()) == num_variables);
+    NodeID result = TRUE_NODE;
+    for (int var = num_variables - 1; var >= 0; --var) {
+        if (assignment[var] == 0) {
+            result = make_node(var, result, FALSE_NODE);
+        } else if (assignment[var] == 1) {
+            result = make_node(var, FALSE_NODE, result);
+        }
+    }
+    return result;
+}
+
+NodeID DDManager::apply_and(NodeID first, NodeID second) {
+    if (first == FALSE_NODE || second == FALSE_NODE) {
+        return FALSE_NODE;
+    } else if (first == TRUE_NODE || first == second) {
+        return second;
+    } else if (second == TRUE_NODE) {
+        return first;
+    }
+    if (first > second) {
+        swap(first, second);
+    }
+    NodeID result;
+    if (lookup_cache(AND, first, second, 0, result)) {
+        return result;
+    }
+    int var = get_top_variable(first, second);
+    NodeID low = apply_and(get_cofactor(first, var, false),
+                           get_cofactor(second, var, false));
+    NodeID high = apply_and(get_cofactor(first, var, true),
+                            get_cofactor(second, var, true));
+    result = make_node(var, low, high);
+    insert_cache(AND, first, second, 0, result);
+    return result;
+}
+
+NodeID DDManager::apply_or(NodeID first, NodeID second) {
+    if (first == TRUE_NODE || second == TRUE_NODE) {
+        return TRUE_NODE;
+    } else if (first == FALSE_NODE || first == second) {
+        return second;
+    } else if (second == FALSE_NODE) {
+        return first;
+    }
+    if (first > second) {
+        swap(first, second);
+    }
+    NodeID result;
+    if (lookup_cache(OR, first, second, 0, result)) {
+        return result;
+    }
+    int var = get_top_variable(first, second);
+    NodeID low = apply_or(get_cofactor(first, var, false),
+                          get_cofactor(second, var, false));
+    NodeID high = apply_or(get_cofactor(first, var, true),
+                           get_cofactor(second, var, true));
+    result = make_node(var, low, high);
+    insert_cache(OR, first, second, 0, result);
+    return result;
+}
+
+NodeID DDManager::negate(NodeID node) {
+    if (node == FALSE_NODE) {
+        return TRUE_NODE;
+    } else if (node == TRUE_NODE) {
+        return FALSE_NODE;
+    }
+    assert(!is_terminal(node));
+    NodeID result;
+    if (lookup_cache(NOT, node, 0, 0, result)) {
+        return result;
+    }
+    const Node &n = nodes[node];
+    int var = n.var;
+    NodeID high = n.high;
+    NodeID low = negate(n.low);
+    high = negate(high);
+    result = make_node(var, low, high);
+    insert_cache(NOT, node, 0, 0, result);
+    return result;
+}
+
+NodeID DDManager::if_then_else(
+    NodeID condition, NodeID then_node, NodeID else_node) {
+    if (condition == TRUE_NODE || then_node == else_node) {
+        return then_node;
+    } else if (condition == FALSE_NODE) {
+        return else_node;
+    }
+    assert(!is_terminal(condition));
+    NodeID result;
+    if (lookup_cache(IF_THEN_ELSE, condition, then_node, else_node, result)) {
+        return result;
+    }
+    int var = min(nodes[condition].var, get_top_variable(then_node, else_node));
+    NodeID low = if_then_else(get_cofactor(condition, var, false),
+                              get_cofactor(then_node, var, false),
+                              get_cofactor(else_node, var, false));
+    NodeID high = if_then_else(get_cofactor(condition, var, true),
+                               get_cofactor(then_node, var, true),
+                               get_cofactor(else_node, var, true));
+    result = make_node(var, low, high);
+    insert_cache(IF_THEN_ELSE, condition, then_node, else_node, result);
+    return result;
+}
+
+NodeID DDManager::restrict(NodeID node, NodeID cube) {
+    if (cube == TRUE_NODE || is_terminal(node)) {
+        return node;
+    }
+    assert(cube != FALSE_NODE);
+    NodeID result;
+    if (lookup_cache(RESTRICT, node, cube, 0, result)) {
+        return result;
+    }
+    Node n = nodes[node];
+    const Node &c = nodes[cube];
+    // Each node of a cube has exactly one child that is not FALSE_NODE.
+    bool value = c.low == FALSE_NODE;
+    NodeID rest_of_cube = value ? c.high : c.low;
+    if (c.var < n.var) {
+        result = restrict(node, rest_of_cube);
+    } else if (c.var == n.var) {
+        result = restrict(value ? n.high : n.low, rest_of_cube);
+    } else {
+        NodeID low = restrict(n.low, cube);
+        NodeID high = restrict(n.high, cube);
+        result = make_node(n.var, low, high);
+    }
+    insert_cache(RESTRICT, node, cube, 0, result);
+    return result;
+}
+
+int DDManager::count_nodes(NodeID node) const {
+    vector<bool> reached(nodes.size(), false);
+    vector<NodeID> stack = {node};
+    reached[node] = true;
+    int num_reached = 0;
+    while (!stack.empty()) {
+        NodeID id = stack.back();
+        stack.pop_back();
+        ++num_reached;
+        if (!is_terminal(id)) {
+            for (NodeID child : {nodes[id].low, nodes[id].high}) {
+                if (!reached[child]) {
+                    reached[child] = true;
+                    stack.push_back(child);
+                }
+            }
+        }
+    }
+    return num_reached;
+}
+
+void DDManager::collect_garbage(const vector<NodeID *> &roots) {
+    vector<bool> reached(nodes.size(), false);
+    reached[FALSE_NODE] = true;
+    reached[TRUE_NODE] = true;
+    vector<NodeID> stack;
+    for (NodeID *root : roots) {
+        if (!reached[*root]) {
+            reached[*root] = true;
+            stack.push_back(*root);
+        }
+    }
+    while (!stack.empty()) {
+        NodeID id = stack.back();
+        stack.pop_back();
+        if (!is_terminal(id)) {
+            for (NodeID child : {nodes[id].low, nodes[id].high}) {
+                if (!reached[child]) {
+                    reached[child] = true;
+                    stack.push_back(child);
+                }
+            }
+        }
+    }
+
+    /*
+      Nodes are created after their children, so the children of a node
+      have smaller IDs and are moved before the node itself.
+    */
+    vector<NodeID> new_ids(nodes.size(), -1);
+    NodeID num_kept = 0;
+    for (size_t id = 0; id < nodes.size(); ++id) {
+        if (reached[id]) {
+            Node node = nodes[id];
+            if (node.var != num_variables) {
+                node.low = new_ids[node.low];
+                node.high = new_ids[node.high];
+                assert(node.low != -1 && node.high != -1);
+            }
+            new_ids[id] = num_kept;
+            nodes[num_kept++] = node;
+        }
+    }
+    nodes.resize(num_kept);
+    nodes.shrink_to_fit();
+    for (NodeID *root : roots) {
+        *root = new_ids[*root];
+    }
+
+    size_t unique_table_size = MIN_UNIQUE_TABLE_SIZE;
+    while (nodes.size() * 2 > unique_table_size) {
+        unique_table_size *= 2;
+    }
+    resize_tables(unique_table_size);
+}
+}
@@ -0,0 +1,127 @@
+#ifndef ALGORITHMS_DECISION_DIAGRAMS_H
+#define ALGORITHMS_DECISION_DIAGRAMS_H
+
+#include <cstdint>
+#include <vector>
+
+namespace decision_diagrams {
+/*
+  Reduced ordered decision diagrams over the binary variables
+  0, ..., num_variables - 1, where variable 0 is tested first, with
+  integer terminals. Diagrams whose terminals are 0 and 1 are BDDs and
+  represent sets of assignments; diagrams with other terminals map
+  assignments to integers (they are also known as MTBDDs or ADDs).
+
+  A diagram is identified by the ID of its root node. All diagrams of a
+  manager share their nodes, and identical functions have the same ID.
+  Nodes are never freed individually: collect_garbage removes all nodes
+  that are not reachable from the given roots and renumbers the others,
+  so all IDs that are still needed must be passed to it.
+*/
+using NodeID = int;
+
+class DDManager {
+    struct Node {
+        int var;
+        // For terminals, var is num_variables and low is the value.
+        NodeID low;
+        NodeID high;
+    };
+
+    struct CacheEntry {
+        int operation;
+        NodeID first;
+        NodeID second;
+        NodeID third;
+        NodeID result;
+    };
+
+    int num_variables;
+    std::vector<Node> nodes;
+    // Open addressing hash table of node IDs; -1 marks empty slots.
+    std::vector<NodeID> unique_table;
+    // Direct-mapped cache of operation results.
+    std::vector<CacheEntry> cache;
+
+    static std::uint64_t hash(int a, int b, int c, int d);
+
+    NodeID find_or_insert(int var, NodeID low, NodeID high);
+    NodeID make_node(int var, NodeID low, NodeID high);
+    void resize_tables(std::size_t unique_table_size);
+
+    bool lookup_cache(int operation, NodeID first, NodeID second,
+                      NodeID third, NodeID &result) const;
+    void insert_cache(int operation, NodeID first, NodeID second,
+                      NodeID third, NodeID result);
+
+    int get_top_variable(NodeID first, NodeID second) const;
+    NodeID get_cofactor(NodeID node, int var, bool value) const;
+
+public:
+    static const NodeID FALSE_NODE = 0;
+    static const NodeID TRUE_NODE = 1;
+
+    explicit DDManager(int num_variables);
+
+    int get_num_variables() const {
+        return num_variables;
+    }
+
+    bool is_terminal(NodeID node) const {
+        return nodes[node].var == num_variables;
+    }
+
+    NodeID get_terminal(int value);
+
+    /*
+      Return the BDD of all assignments that agree with the given
+      assignment, which maps each variable to 0, 1 or -1 (any value).
+    */
+    NodeID make_cube(const std::vector<int> &assignment);
+
+    /*
+      The following operations expect BDDs, except for the last two
+      arguments of if_then_else and the first argument of restrict.
+      Results are cached, so repeating an operation is cheap.
+    */
+    NodeID apply_and(NodeID first, NodeID second);
+    NodeID apply_or(NodeID first, NodeID second);
+    NodeID negate(NodeID node);
+    NodeID if_then_else(NodeID condition, NodeID then_node, NodeID else_node);
+
+    /*
+      Fix the variables of the given cube (see make_cube) to their values
+      in the cube. The result does not depend on these variables.
+    */
+    NodeID restrict(NodeID node, NodeID cube);
+
+    /*
+      Return the terminal value reached by following the given
+      assignment, where get_value(var) returns the value of var.
+    */
+    template<typename GetValue>
+    int evaluate(NodeID node, const GetValue &get_value) const {
+        while (nodes[node].var != num_variables) {
+            const Node &current = nodes[node];
+            node = get_value(current.var) ? current.high : current.low;
+        }
+        return nodes[node].low;
+    }
+
+    // Number of nodes of the given diagram, including terminals.
+    int count_nodes(NodeID node) const;
+
+    // Number of nodes of all diagrams, including unreachable ones.
+    int get_num_nodes() const {
+        return nodes.size();
+    }
+
+    /*
+      Remove all nodes that are not reachable from the IDs pointed to by
+      roots and update these IDs. All other IDs become invalid.
+    */
+    void collect_garbage(const std::vector<NodeID *> &roots);
+};
+}
+
+#endif
@@ -43,8 +43,13 @@ namespace int_hash_set {
   The maximum capacity (i.e., number of buckets) is 2^30 because we
   use a signed integer to store it, we grow the hash set by doubling
   its capacity, and the next larger power of 2 (2^31) is too big for
-  an int. The maximum capacity could be increased by storing the
-  number of buckets in a larger data type.
+  an int.
+
+  Both limits can be lifted by instantiating the set with 64-bit key
+  and hash types (e.g., IntHashSet<H, E, int64_t, uint64_t>), which
+  doubles the size of a bucket. Keys, bucket indices and the capacity
+  all use the key type, and the hash type must be at least as wide as
+  the key type so that all buckets can be addressed.
 
   Note on hash functions:
 
@@ -75,24 +80,32 @@ using HashType = unsigned int;
 static_assert(sizeof(KeyType) == 4, "KeyType does not use 4 bytes");
 static_assert(sizeof(HashType) == 4, "HashType does not use 4 bytes");
 
-template<typename Hasher, typename Equal>
+template<typename Hasher, typename Equal,
+         typename Key = KeyType, typename Hash = HashType>
 class IntHashSet {
+    static_assert(std::numeric_limits<Key>::is_signed,
+                  "IntHashSet needs a signed key type");
+    static_assert(!std::numeric_limits<Hash>::is_signed,
+                  "IntHashSet needs an unsigned hash type");
+    static_assert(sizeof(Hash) >= sizeof(Key),
+                  "IntHashSet needs a hash type at least as wide as the key type");
+
     // Max distance from the ideal bucket to the actual bucket for each key.
     static const int MAX_DISTANCE = 32;
-    static const unsigned int MAX_BUCKETS = std::numeric_limits<unsigned int>::max();
+    static const Key MAX_BUCKETS = std::numeric_limits<Key>::max();
 
     struct Bucket {
-        KeyType key;
-        HashType hash;
+        Key key;
+        Hash hash;
 
-        static const KeyType empty_bucket_key = -1;
+        static const Key empty_bucket_key = -1;
 
         Bucket()
             : key(empty_bucket_key),
               hash(0) {
         }
 
-        Bucket(KeyType key, HashType hash)
+        Bucket(Key key, Hash hash)
             : key(key),
               hash(hash) {
         }
@@ -105,16 +118,16 @@ class IntHashSet {
     Hasher hasher;
     Equal equal;
     std::vector<Bucket> buckets;
-    int num_entries;
+    Key num_entries;
     int num_resizes;
 
-    int capacity() const {
+    Key capacity() const {
         return buckets.size();
     }
 
-    void rehash(int new_capacity) {
+    void rehash(Key new_capacity) {
         assert(new_capacity >= 1);
-        int num_entries_before = num_entries;
+        Key num_entries_before = num_entries;
         std::vector<Bucket> old_buckets = std::move(buckets);
         assert(buckets.empty());
         num_entries = 0;
@@ -130,7 +143,7 @@ class IntHashSet {
     }
 
     void enlarge() {
-        unsigned int num_buckets = buckets.size();
+        Key num_buckets = buckets.size();
         // Verify that the number of buckets is a power of 2.
         assert((num_buckets & (num_buckets - 1)) == 0);
         if (num_buckets > MAX_BUCKETS / 2) {
@@ -145,9 +158,9 @@ class IntHashSet {
         rehash(num_buckets * 2);
     }
 
-    int get_bucket(HashType hash) const {
+    Key get_bucket(Hash hash) const {
         assert(!buckets.empty());
-        unsigned int num_buckets = buckets.size();
+        Key num_buckets = buckets.size();
         // Verify that the number of buckets is a power of 2.
         assert((num_buckets & (num_buckets - 1)) == 0);
         /* We want to return hash % num_buckets. The following line does this
@@ -159,7 +172,7 @@ class IntHashSet {
       Return distance from index1 to index2, only moving right and wrapping
       from the last to the first bucket.
     */
-    int get_distance(int index1, int index2) const {
+    Key get_distance(Key index1, Key index2) const {
         assert(utils::in_bounds(index1, buckets));
         assert(utils::in_bounds(index2, buckets));
         if (index2 >= index1) {
@@ -169,7 +182,7 @@ class IntHashSet {
         }
     }
 
-    int find_next_free_bucket_index(int index) const {
+    Key find_next_free_bucket_index(Key index) const {
         assert(num_entries < capacity());
         assert(utils::in_bounds(index, buckets));
         while (buckets[index].full()) {
@@ -178,11 +191,11 @@ class IntHashSet {
         return index;
     }
 
-    KeyType find_equal_key(KeyType key, HashType hash) const {
+    Key find_equal_key(Key key, Hash hash) const {
         assert(hasher(key) == hash);
-        int ideal_index = get_bucket(hash);
+        Key ideal_index = get_bucket(hash);
         for (int i = 0; i < MAX_DISTANCE; ++i) {
-            int index = get_bucket(ideal_index + i);
+            Key index = get_bucket(ideal_index + i);
             const Bucket &bucket = buckets[index];
             if (bucket.full() && bucket.hash == hash && equal(bucket.key, key)) {
                 return bucket.key;
@@ -205,12 +218,12 @@ class IntHashSet {
       Note that the private insert() may call enlarge() and therefore rehash(),
       which itself calls the private insert() again.
     */
-    std::pair<KeyType, bool> insert(KeyType key, HashType hash) {
+    std::pair<Key, bool> insert(Key key, Hash hash) {
         assert(hasher(key) == hash);
 
         /* If the hash set already contains the key, return the key and a
            Boolean indicating that no new key has been inserted. */
-        KeyType equal_key = find_equal_key(key, hash);
+        Key equal_key = find_equal_key(key, hash);
         if (equal_key != Bucket::empty_bucket_key) {
             return std::make_pair(equal_key, false);
         }
@@ -222,10 +235,10 @@ class IntHashSet {
         assert(num_entries < capacity());
 
         // Compute ideal bucket.
-        int ideal_index = get_bucket(hash);
+        Key ideal_index = get_bucket(hash);
 
         // Find first free bucket left of the ideal bucket.
-        int free_index = find_next_free_bucket_index(ideal_index);
+        Key free_index = find_next_free_bucket_index(ideal_index);
 
         /*
           While the free bucket is too far from the ideal bucket, move the free
@@ -236,15 +249,16 @@ class IntHashSet {
         */
         while (get_distance(ideal_index, free_index) >= MAX_DISTANCE) {
             bool swapped = false;
-            int num_buckets = capacity();
-            int max_offset = std::min(MAX_DISTANCE, num_buckets) - 1;
+            Key num_buckets = capacity();
+            int max_offset = static_cast<int>(
+                std::min<Key>(MAX_DISTANCE, num_buckets)) - 1;
             for (int offset = max_offset; offset >= 1; --offset) {
                 assert(offset < num_buckets);
-                int candidate_index = free_index + num_buckets - offset;
+                Key candidate_index = free_index + num_buckets - offset;
                 assert(candidate_index >= 0);
                 candidate_index = get_bucket(candidate_index);
-                HashType candidate_hash = buckets[candidate_index].hash;
-                int candidate_ideal_index = get_bucket(candidate_hash);
+                Hash candidate_hash = buckets[candidate_index].hash;
+                Key candidate_ideal_index = get_bucket(candidate_hash);
                 if (get_distance(candidate_ideal_index, free_index) < MAX_DISTANCE) {
                     // Candidate can be swapped.
                     std::swap(buckets[candidate_index], buckets[free_index]);
@@ -276,7 +290,7 @@ public:
           num_resizes(0) {
     }
 
-    int size() const {
+    Key size() const {
         return num_entries;
     }
 
@@ -287,15 +301,15 @@ public:
       already contained in the hash set. The second item in the pair is a bool
       indicating whether a new key was inserted into the hash set.
     */
-    std::pair<KeyType, bool> insert(KeyType key) {
+    std::pair<Key, bool> insert(Key key) {
         assert(key >= 0);
         return insert(key, hasher(key));
     }
 
     void dump() const {
-        int num_buckets = capacity();
+        Key num_buckets = capacity();
         utils::g_log << "[";
-        for (int i = 0; i < num_buckets; ++i) {
+        for (Key i = 0; i < num_buckets; ++i) {
             const Bucket &bucket = buckets[i];
             if (bucket.full()) {
                 utils::g_log << bucket.key;
@@ -311,7 +325,7 @@ public:
 
     void print_statistics() const {
         assert(!buckets.empty());
-        int num_buckets = capacity();
+        Key num_buckets = capacity();
         assert(num_buckets != 0);
         utils::g_log << "Int hash set load factor: " << num_entries << "/"
                      << num_buckets << " = "
@@ -321,11 +335,11 @@ public:
     }
 };
 
-template<typename Hasher, typename Equal>
-const int IntHashSet<Hasher, Equal>::MAX_DISTANCE;
+template<typename Hasher, typename Equal, typename Key, typename Hash>
+const int IntHashSet<Hasher, Equal, Key, Hash>::MAX_DISTANCE;
 
-template<typename Hasher, typename Equal>
-const unsigned int IntHashSet<Hasher, Equal>::MAX_BUCKETS;
+template<typename Hasher, typename Equal, typename Key, typename Hash>
+const Key IntHashSet<Hasher, Equal, Key, Hash>::MAX_BUCKETS;
 }
 
 #endif
@@ -62,6 +62,15 @@ public:
         Bin &bin = buffer[bin_index];
         bin = (bin & clear_mask) | (value << shift);
     }
+
+    BinAssignment get_assignment(int value) const {
+        assert(value >= 0 && value < range);
+        return {bin_index, clear_mask, Bin(value) << shift};
+    }
+
+    BinExtraction get_extraction() const {
+        return {bin_index, read_mask, shift};
+    }
 };
 
 
@@ -81,6 +90,14 @@ void IntPacker::set(Bin *buffer, int var, int value) const {
     var_infos[var].set(buffer, value);
 }
 
+IntPacker::BinAssignment IntPacker::get_bin_assignment(int var, int value) const {
+    return var_infos[var].get_assignment(value);
+}
+
+IntPacker::BinExtraction IntPacker::get_bin_extraction(int var) const {
+    return var_infos[var].get_extraction();
+}
+
 void IntPacker::pack_bins(const vector<int> &ranges) {
     assert(var_infos.empty());
 
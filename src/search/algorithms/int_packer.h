@@ -30,6 +30,26 @@ class IntPacker {
 public:
     typedef unsigned int Bin;
 
+    /*
+      Setting a variable to a value amounts to
+      buffer[bin_index] = (buffer[bin_index] & clear_mask) | set_mask.
+    */
+    struct BinAssignment {
+        int bin_index;
+        Bin clear_mask;
+        Bin set_mask;
+    };
+
+    /*
+      The value of a variable is
+      (buffer[bin_index] & read_mask) >> shift.
+    */
+    struct BinExtraction {
+        int bin_index;
+        Bin read_mask;
+        int shift;
+    };
+
     /*
       The constructor takes the range for each variable. The domain of
       variable i is {0, ..., ranges[i] - 1}. Because we are using signed
@@ -42,6 +62,18 @@ public:
     int get(const Bin *buffer, int var) const;
     void set(Bin *buffer, int var, int value) const;
 
+    /*
+      Return the bin operation that sets var to value. This allows
+      precomputing the effect of setting several variables.
+    */
+    BinAssignment get_bin_assignment(int var, int value) const;
+
+    /*
+      Return the bin operation that reads var. This allows reading
+      several variables without a call to get for each of them.
+    */
+    BinExtraction get_bin_extraction(int var) const;
+
     int get_num_bins() const {return num_bins;}
 };
 }
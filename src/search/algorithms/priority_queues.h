@@ -243,43 +243,63 @@ public:
 
 template<typename Value>
 class AdaptiveQueue {
-    AbstractQueue<Value> *wrapped_queue;
+    /*
+      Until the conversion, we call the bucket queue directly instead of
+      through an AbstractQueue pointer, so that the compiler can resolve
+      and inline the calls. With small integer costs (e.g., unit costs),
+      the conversion never happens.
+    */
+    BucketQueue<Value> bucket_queue;
+    AbstractQueue<Value> *heap_queue;
     // Forbid assigning or copying -- would need to implement them properly.
     AdaptiveQueue &operator=(const AdaptiveQueue<Value> &);
     AdaptiveQueue(const AdaptiveQueue<Value> &);
 public:
     typedef std::pair<int, Value> Entry;
 
-    AdaptiveQueue() : wrapped_queue(new BucketQueue<Value>) {
+    AdaptiveQueue() : heap_queue(nullptr) {
     }
 
     ~AdaptiveQueue() {
-        delete wrapped_queue;
+        delete heap_queue;
     }
 
     void push(int key, const Value &value) {
-        AbstractQueue<Value> *q = wrapped_queue->convert_if_necessary(key);
-        if (q != wrapped_queue) {
-            delete wrapped_queue;
-            wrapped_queue = q;
+        if (!heap_queue) {
+            AbstractQueue<Value> *q = bucket_queue.convert_if_necessary(key);
+            if (q == &bucket_queue) {
+                bucket_queue.push(key, value);
+                return;
+            }
+            heap_queue = q;
         }
-        wrapped_queue->push(key, value);
+        heap_queue->push(key, value);
     }
 
     Entry pop() {
-        return wrapped_queue->pop();
+        if (!heap_queue)
+            return bucket_queue.pop();
+        return heap_queue->pop();
     }
 
     bool empty() const {
-        return wrapped_queue->empty();
+        if (!heap_queue)
+            return bucket_queue.empty();
+        return heap_queue->empty();
     }
 
     void clear() {
-        wrapped_queue->clear();
+        if (!heap_queue)
+            bucket_queue.clear();
+        else
+            heap_queue->clear();
     }
 
     void add_virtual_pushes(int num_extra_pushes) {
-        wrapped_queue->add_virtual_pushes(num_extra_pushes);
+        if (!heap_queue)
+            bucket_queue.add_virtual_pushes(num_extra_pushes);
+        else
+            heap_queue->add_virtual_pushes(num_extra_pushes);
     }
 };
 }
@@ -0,0 +1,88 @@
+#include "effect_programs.h"
+
+#include "task_proxy.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+using namespace std;
+
+EffectPrograms::EffectPrograms(
+    const TaskProxy &task_proxy, const int_packer::IntPacker &state_packer)
+    : state_packer(state_packer) {
+    OperatorsProxy operators = task_proxy.get_operators();
+    programs.resize(operators.size());
+    for (OperatorProxy op : operators) {
+        compile_operator(op, programs[op.get_id()]);
+    }
+}
+
+void EffectPrograms::compile_operator(
+    const OperatorProxy &op, Program &program) const {
+    EffectsProxy effects = op.get_effects();
+
+    /*
+      Compiling an unconditional effect into a bin assignment moves it in
+      front of all conditional effects. This is only safe if no conditional
+      effect affects the same variable.
+    */
+    unordered_set<int> conditionally_affected_vars;
+    for (EffectProxy effect : effects) {
+        if (!effect.get_conditions().empty()) {
+            conditionally_affected_vars.insert(effect.get_fact().get_variable().get_id());
+        }
+    }
+
+    for (EffectProxy effect : effects) {
+        EffectConditionsProxy conditions = effect.get_conditions();
+        FactPair fact = effect.get_fact().get_pair();
+        if (conditions.empty() &&
+            !conditionally_affected_vars.count(fact.var)) {
+            int_packer::IntPacker::BinAssignment assignment =
+                state_packer.get_bin_assignment(fact.var, fact.value);
+            auto it = find_if(
+                program.bin_assignments.begin(), program.bin_assignments.end(),
+                [&](const int_packer::IntPacker::BinAssignment &other) {
+                    return other.bin_index == assignment.bin_index;
+                });
+            if (it == program.bin_assignments.end()) {
+                program.bin_assignments.push_back(assignment);
+            } else {
+                // Merge with the effects on other variables in the same bin.
+                it->clear_mask &= assignment.clear_mask;
+                it->set_mask = (it->set_mask & assignment.clear_mask) |
+                    assignment.set_mask;
+            }
+            program.compiled_facts.push_back(fact);
+        } else {
+            program.effects.emplace_back(fact);
+            Effect &compiled_effect = program.effects.back();
+            for (FactProxy condition : conditions) {
+                compiled_effect.conditions.push_back(condition.get_pair());
+            }
+        }
+    }
+    sort(program.bin_assignments.begin(), program.bin_assignments.end(),
+         [](const int_packer::IntPacker::BinAssignment &lhs,
+            const int_packer::IntPacker::BinAssignment &rhs) {
+             return lhs.bin_index < rhs.bin_index;
+         });
+}
+
+void EffectPrograms::apply(
+    int op_id, const vector<int> &predecessor_values, vector<int> &values) const {
+    const Program &program = programs[op_id];
+    for (const FactPair &fact : program.compiled_facts) {
+        values[fact.var] = fact.value;
+    }
+    for (const Effect &effect : program.effects) {
+        bool fires = all_of(
+            effect.conditions.begin(), effect.conditions.end(),
+            [&](const FactPair &condition) {
+                return predecessor_values[condition.var] == condition.value;
+            });
+        if (fires) {
+            values[effect.fact.var] = effect.fact.value;
+        }
+    }
+}
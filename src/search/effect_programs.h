@@ -0,0 +1,88 @@
+#ifndef EFFECT_PROGRAMS_H
+#define EFFECT_PROGRAMS_H
+
+#include "abstract_task.h"
+
+#include "algorithms/int_packer.h"
+
+#include <vector>
+
+class OperatorProxy;
+class TaskProxy;
+
+using PackedStateBin = int_packer::IntPacker::Bin;
+
+/*
+  Precompiled effects of all operators of a task, used by StateRegistry to
+  compute successor states directly on packed state data without going
+  through the task interface.
+
+  The unconditional effects of an operator are compiled into one masked assignment
+  buffer[bin] = (buffer[bin] & clear_mask) | set_mask per affected bin.
+  All remaining effects (conditional effects, effects on variables that are
+  also affected by a conditional effect of the same operator) are stored as plain facts with
+  their conditions and applied in their original order through the
+  state packer.
+*/
+class EffectPrograms {
+    struct Effect {
+        std::vector<FactPair> conditions;
+        FactPair fact;
+
+        explicit Effect(const FactPair &fact)
+            : fact(fact) {
+        }
+    };
+
+    struct Program {
+        std::vector<int_packer::IntPacker::BinAssignment> bin_assignments;
+        std::vector<Effect> effects;
+        // The facts compiled into bin_assignments (for unpacked values).
+        std::vector<FactPair> compiled_facts;
+    };
+
+    const int_packer::IntPacker &state_packer;
+    std::vector<Program> programs;
+
+    void compile_operator(const OperatorProxy &op, Program &program) const;
+public:
+    EffectPrograms(
+        const TaskProxy &task_proxy, const int_packer::IntPacker &state_packer);
+
+    /*
+      Apply the effects of the operator with the given ID to buffer, which
+      must initially hold a copy of the packed predecessor data. Effect
+      conditions are evaluated on the predecessor.
+    */
+    void apply(int op_id, const PackedStateBin *predecessor,
+               PackedStateBin *buffer) const {
+        const Program &program = programs[op_id];
+        for (const int_packer::IntPacker::BinAssignment &assignment :
+             program.bin_assignments) {
+            PackedStateBin &bin = buffer[assignment.bin_index];
+            bin = (bin & assignment.clear_mask) | assignment.set_mask;
+        }
+        for (const Effect &effect : program.effects) {
+            bool fires = true;
+            for (const FactPair &condition : effect.conditions) {
+                if (state_packer.get(predecessor, condition.var) !=
+                    condition.value) {
+                    fires = false;
+                    break;
+                }
+            }
+            if (fires) {
+                state_packer.set(buffer, effect.fact.var, effect.fact.value);
+            }
+        }
+    }
+
+    /*
+      Apply the effects of the operator with the given ID to values, which
+      must initially be a copy of predecessor_values.
+    */
+    void apply(int op_id, const std::vector<int> &predecessor_values,
+               std::vector<int> &values) const;
+};
+
+#endif
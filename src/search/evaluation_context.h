@@ -55,6 +55,8 @@ class EvaluationContext {
     SearchStatistics *statistics;
     bool calculate_preferred;
 
+    void count_evaluation(Evaluator *eval, const EvaluationResult &result);
+
     EvaluationContext(
         const EvaluatorCache &cache, State state,
         OperatorID operator_id, bool is_preferred,
@@ -91,6 +93,16 @@ public:
         SearchStatistics *statistics = nullptr, bool calculate_preferred = false);
 
     const EvaluationResult &get_result(Evaluator *eval);
+    bool has_result(Evaluator *eval) const;
+    /*
+      Store a result that was computed outside of this context (see
+      Evaluator::compute_results). There must be no result for eval yet.
+      Until get_result is called for eval, the result does not count as
+      an evaluation and is not visible to for_each_evaluator_result of the
+      cache, so precomputing results does not change statistics or
+      progress reports.
+    */
+    void set_result(Evaluator *eval, EvaluationResult &&result);
     const EvaluatorCache &get_cache() const;
     // TODO: it's a bit hacky but I will use this for both types of entry
     const State &get_state() const;
@@ -193,15 +205,39 @@ inline const EvaluationResult &EvaluationContext<Entry>::get_result(Evaluator *e
     EvaluationResult &result = cache[evaluator];
     if (result.is_uninitialized()) {
         result = evaluator->compute_result(*this);
-        if (statistics &&
-            evaluator->is_used_for_counting_evaluations() &&
-            result.get_count_evaluation()) {
-            statistics->inc_evaluations();
-        }
+        count_evaluation(evaluator, result);
+    } else if (result.is_unused_batch_result()) {
+        result.set_unused_batch_result(false);
+        count_evaluation(evaluator, result);
     }
     return result;
 }
 
+template<typename Entry>
+inline bool EvaluationContext<Entry>::has_result(Evaluator *eval) const {
+    return cache.has_result(eval);
+}
+
+template<typename Entry>
+inline void EvaluationContext<Entry>::set_result(
+    Evaluator *eval, EvaluationResult &&result) {
+    EvaluationResult &cached_result = cache[eval];
+    assert(cached_result.is_uninitialized());
+    cached_result = move(result);
+    // We count the evaluation when the result is first used (see get_result).
+    cached_result.set_unused_batch_result(true);
+}
+
+template<typename Entry>
+inline void EvaluationContext<Entry>::count_evaluation(
+    Evaluator *eval, const EvaluationResult &result) {
+    if (statistics &&
+        eval->is_used_for_counting_evaluations() &&
+        result.get_count_evaluation()) {
+        statistics->inc_evaluations();
+    }
+}
+
 template<typename Entry>
 inline const EvaluatorCache &EvaluationContext<Entry>::get_cache() const {
     return cache;
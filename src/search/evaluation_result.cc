@@ -4,7 +4,10 @@ using namespace std;
 
 const int EvaluationResult::INFTY = numeric_limits<int>::max();
 
-EvaluationResult::EvaluationResult() : evaluator_value(UNINITIALIZED) {
+EvaluationResult::EvaluationResult()
+    : evaluator_value(UNINITIALIZED),
+      count_evaluation(false),
+      unused_batch_result(false) {
 }
 
 bool EvaluationResult::is_uninitialized() const {
@@ -27,6 +30,10 @@ bool EvaluationResult::get_count_evaluation() const {
     return count_evaluation;
 }
 
+bool EvaluationResult::is_unused_batch_result() const {
+    return unused_batch_result;
+}
+
 void EvaluationResult::set_evaluator_value(int value) {
     evaluator_value = value;
 }
@@ -39,3 +46,7 @@ void EvaluationResult::set_preferred_operators(
 void EvaluationResult::set_count_evaluation(bool count_eval) {
     count_evaluation = count_eval;
 }
+
+void EvaluationResult::set_unused_batch_result(bool unused) {
+    unused_batch_result = unused;
+}
@@ -10,8 +10,14 @@ class EvaluationResult {
     static const int UNINITIALIZED = -2;
 
     int evaluator_value;
-    std::vector<OperatorID> preferred_operators;
     bool count_evaluation;
+    /*
+      True for results that were computed for a batch (see
+      Evaluator::compute_results) and have not been used yet. They are
+      only counted as evaluations once they are used.
+    */
+    bool unused_batch_result;
+    std::vector<OperatorID> preferred_operators;
 public:
     // "INFINITY" is an ISO C99 macro and "INFINITE" is a macro in windows.h.
     static const int INFTY;
@@ -42,11 +48,13 @@ public:
     bool is_infinite() const;
     int get_evaluator_value() const;
     bool get_count_evaluation() const;
+    bool is_unused_batch_result() const;
     const std::vector<OperatorID> &get_preferred_operators() const;
 
     void set_evaluator_value(int value);
     void set_preferred_operators(std::vector<OperatorID> &&preferred_operators);
     void set_count_evaluation(bool count_eval);
+    void set_unused_batch_result(bool unused);
 };
 
 #endif
@@ -1,30 +1,85 @@
 #include "evaluator.h"
 
+#include "evaluation_context.h"
 #include "option_parser.h"
 #include "plugin.h"
 
 #include "utils/logging.h"
 #include "utils/system.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <mutex>
 
 using namespace std;
 
+namespace {
+class EvaluatorIDs {
+    mutex ids_mutex;
+    vector<int> free_ids;
+    // Evaluation contexts read this without locking the mutex.
+    atomic<int> num_ids {0};
+public:
+    int allocate() {
+        lock_guard<mutex> lock(ids_mutex);
+        if (free_ids.empty()) {
+            return num_ids++;
+        }
+        // Hand out the smallest free index to keep the indices dense.
+        auto it = min_element(free_ids.begin(), free_ids.end());
+        int id = *it;
+        *it = free_ids.back();
+        free_ids.pop_back();
+        return id;
+    }
+
+    void release(int id) {
+        lock_guard<mutex> lock(ids_mutex);
+        free_ids.push_back(id);
+    }
+
+    int get_num_ids() const {
+        return num_ids.load(memory_order_relaxed);
+    }
+};
+
+EvaluatorIDs &get_evaluator_ids() {
+    static EvaluatorIDs evaluator_ids;
+    return evaluator_ids;
+}
+}
 
 Evaluator::Evaluator(const string &description,
                      bool use_for_reporting_minima,
                      bool use_for_boosting,
                      bool use_for_counting_evaluations)
-    : description(description),
+    : id(get_evaluator_ids().allocate()),
+      description(description),
       use_for_reporting_minima(use_for_reporting_minima),
       use_for_boosting(use_for_boosting),
       use_for_counting_evaluations(use_for_counting_evaluations) {
 }
 
+Evaluator::~Evaluator() {
+    get_evaluator_ids().release(id);
+}
+
+int Evaluator::get_num_ids() {
+    return get_evaluator_ids().get_num_ids();
+}
+
 bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
 
+void Evaluator::compute_results(vector<StateEvaluationContext> &) {
+}
+
+bool Evaluator::supports_batch_evaluation() const {
+    return false;
+}
+
 void Evaluator::report_value_for_initial_state(const EvaluationResult &result) const {
     assert(use_for_reporting_minima);
     utils::g_log << "Initial heuristic value for " << description << ": ";
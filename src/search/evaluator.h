@@ -5,6 +5,7 @@
 #include "state_id.h"
 
 #include <set>
+#include <vector>
 
 template<typename Entry>
 class EvaluationContext;
@@ -17,6 +18,12 @@ using StateEvaluationContext = EvaluationContext<StateEvaluationContextEntry>;
 using EdgeEvaluationContext = EvaluationContext<EdgeEvaluationContextEntry>;
 
 class Evaluator {
+    /*
+      Dense index of this evaluator among all evaluators that currently
+      exist. EvaluatorCache uses it to store results in a flat array.
+      Indices of destroyed evaluators are reused.
+    */
+    const int id;
     const std::string description;
     const bool use_for_reporting_minima;
     const bool use_for_boosting;
@@ -28,7 +35,9 @@ public:
         bool use_for_reporting_minima = false,
         bool use_for_boosting = false,
         bool use_for_counting_evaluations = false);
-    virtual ~Evaluator() = default;
+    virtual ~Evaluator();
+    Evaluator(const Evaluator &) = delete;
+    Evaluator &operator=(const Evaluator &) = delete;
 
     /*
       dead_ends_are_reliable should return true if the evaluator is
@@ -87,9 +96,35 @@ public:
     // TODO can we avoid code duplication here? virtual functions cannot be templated.
     virtual EvaluationResult compute_result(EdgeEvaluationContext &) = 0;
 
+    /*
+      compute_results may compute the results for the evaluation contexts
+      of a batch (e.g., all new successors of an expanded state) that have
+      no result for this evaluator yet, and store them in the contexts.
+      Later calls to EvaluationContext::get_result then look them up
+      instead of calling compute_result.
+
+      The default implementation does nothing, so the results are computed
+      on demand as usual. Evaluators override this if they can share work
+      between the states of a batch. Results for contexts that do not ask
+      for preferred operators (see EvaluationContext::get_calculate_preferred)
+      do not need to include them.
+
+      supports_batch_evaluation should return true if compute_results
+      (directly or through a subevaluator) does any work. Search engines
+      only build batches if it does. The default implementation returns
+      false.
+    */
+    virtual void compute_results(std::vector<StateEvaluationContext> &batch);
+    virtual bool supports_batch_evaluation() const;
+
     void report_value_for_initial_state(const EvaluationResult &result) const;
     void report_new_minimum_value(const EvaluationResult &result) const;
 
+    int get_id() const {
+        return id;
+    }
+    // Return an upper bound on the IDs of all existing evaluators.
+    static int get_num_ids();
     const std::string &get_description() const;
     bool is_used_for_reporting_minima() const;
     bool is_used_for_boosting() const;
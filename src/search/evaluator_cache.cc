@@ -3,6 +3,11 @@
 using namespace std;
 
 
-EvaluationResult &EvaluatorCache::operator[](Evaluator *eval) {
-    return eval_results[eval];
+bool EvaluatorCache::has_result(Evaluator *eval) const {
+    int id = eval->get_id();
+    if (id >= static_cast<int>(entries.size())) {
+        return false;
+    }
+    const Entry &entry = entries[id];
+    return entry.eval == eval && !entry.result.is_uninitialized();
 }
@@ -2,28 +2,58 @@
 #define EVALUATOR_CACHE_H
 
 #include "evaluation_result.h"
+#include "evaluator.h"
 
-#include <unordered_map>
-
-class Evaluator;
-
-using EvaluationResults = std::unordered_map<Evaluator *, EvaluationResult>;
+#include <algorithm>
+#include <vector>
 
 /*
   Store evaluation results for evaluators.
+
+  Results are stored in a flat array indexed by the dense evaluator IDs
+  (see Evaluator::get_id). The array is allocated when the first result
+  is stored and is sized for all evaluators that exist at that time, so
+  a cache allocates memory at most once unless further evaluators are
+  created later.
 */
 class EvaluatorCache {
-    EvaluationResults eval_results;
+    struct Entry {
+        Evaluator *eval;
+        EvaluationResult result;
+
+        Entry() : eval(nullptr) {
+        }
+    };
+
+    std::vector<Entry> entries;
+
+    Entry &get_entry(int id) {
+        if (id >= static_cast<int>(entries.size())) {
+            entries.resize(std::max(id + 1, Evaluator::get_num_ids()));
+        }
+        return entries[id];
+    }
 
 public:
-    EvaluationResult &operator[](Evaluator *eval);
+    EvaluationResult &operator[](Evaluator *eval) {
+        Entry &entry = get_entry(eval->get_id());
+        if (entry.eval != eval) {
+            // The entry is unused or belongs to a destroyed evaluator.
+            entry.eval = eval;
+            entry.result = EvaluationResult();
+        }
+        return entry.result;
+    }
+
+    bool has_result(Evaluator *eval) const;
 
+    // Results computed for a batch that were not used yet are skipped.
     template<class Callback>
     void for_each_evaluator_result(const Callback &callback) const {
-        for (const auto &element : eval_results) {
-            const Evaluator *eval = element.first;
-            const EvaluationResult &result = element.second;
-            callback(eval, result);
+        for (const Entry &entry : entries) {
+            if (entry.eval && !entry.result.is_unused_batch_result()) {
+                callback(entry.eval, entry.result);
+            }
         }
     }
 };
@@ -68,6 +68,19 @@ EvaluationResult CombiningEvaluator::compute_result(
     return result;
 }
 
+void CombiningEvaluator::compute_results(vector<StateEvaluationContext> &batch) {
+    // Combining the values is cheap, but the subevaluators may share work.
+    for (const shared_ptr<Evaluator> &subevaluator : subevaluators)
+        subevaluator->compute_results(batch);
+}
+
+bool CombiningEvaluator::supports_batch_evaluation() const {
+    for (const shared_ptr<Evaluator> &subevaluator : subevaluators)
+        if (subevaluator->supports_batch_evaluation())
+            return true;
+    return false;
+}
+
 void CombiningEvaluator::get_path_dependent_evaluators(
     set<Evaluator *> &evals) {
     for (auto &subevaluator : subevaluators)
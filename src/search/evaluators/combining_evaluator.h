@@ -39,6 +39,9 @@ public:
     virtual bool dead_ends_are_reliable() const override;
     virtual EvaluationResult compute_result(StateEvaluationContext &eval_context) override;
     virtual EvaluationResult compute_result(EdgeEvaluationContext &eval_context) override;
+    virtual void compute_results(
+        std::vector<StateEvaluationContext> &batch) override;
+    virtual bool supports_batch_evaluation() const override;
 
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) override;
@@ -51,6 +51,14 @@ EvaluationResult WeightedEvaluator::compute_result(EdgeEvaluationContext &eval_c
     return result;
 }
 
+void WeightedEvaluator::compute_results(vector<StateEvaluationContext> &batch) {
+    evaluator->compute_results(batch);
+}
+
+bool WeightedEvaluator::supports_batch_evaluation() const {
+    return evaluator->supports_batch_evaluation();
+}
+
 void WeightedEvaluator::get_path_dependent_evaluators(set<Evaluator *> &evals) {
     evaluator->get_path_dependent_evaluators(evals);
 }
@@ -4,6 +4,7 @@
 #include "evaluation_result.h"
 #include "option_parser.h"
 #include "plugin.h"
+#include "state_registry.h"
 
 #include "task_utils/task_properties.h"
 #include "tasks/cost_adapted_task.h"
@@ -34,6 +35,29 @@ State Heuristic::convert_ancestor_state(const State &ancestor_state) const {
     return task_proxy.convert_ancestor_state(ancestor_state);
 }
 
+const int_packer::IntPacker *Heuristic::get_state_packer(
+    const State &ancestor_state) const {
+    const StateRegistry *registry = ancestor_state.get_registry();
+    if (registry && task_proxy.keeps_ancestor_state_values(ancestor_state)) {
+        return &registry->get_state_packer();
+    }
+    return nullptr;
+}
+
+const int_packer::IntPacker *Heuristic::get_state_packer(
+    const vector<State> &ancestor_states) const {
+    if (ancestor_states.empty()) {
+        return nullptr;
+    }
+    const StateRegistry *registry = ancestor_states.front().get_registry();
+    for (const State &ancestor_state : ancestor_states) {
+        if (ancestor_state.get_registry() != registry) {
+            return nullptr;
+        }
+    }
+    return get_state_packer(ancestor_states.front());
+}
+
 void Heuristic::add_options_to_parser(OptionParser &parser) {
     parser.add_option<shared_ptr<AbstractTask>>(
         "transform",
@@ -147,6 +171,56 @@ EvaluationResult Heuristic::compute_result(EdgeEvaluationContext &eval_context)
     return result;
 }
 
+void Heuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &heuristics) {
+    for (const State &ancestor_state : ancestor_states) {
+        heuristics.push_back(compute_heuristic(ancestor_state));
+        preferred_operators.clear();
+    }
+}
+
+void Heuristic::compute_batch_results(vector<StateEvaluationContext> &batch) {
+    assert(preferred_operators.empty());
+    batch_contexts.clear();
+    batch_states.clear();
+    for (StateEvaluationContext &eval_context : batch) {
+        if (eval_context.has_result(this) ||
+            eval_context.get_calculate_preferred())
+            continue;
+        const State &state = eval_context.get_state();
+        if (cache_evaluator_values && heuristic_cache[state].h != NO_VALUE &&
+            !heuristic_cache[state].dirty)
+            continue;
+        batch_contexts.push_back(&eval_context);
+        batch_states.push_back(state);
+    }
+    if (batch_states.empty())
+        return;
+
+    batch_heuristics.clear();
+    compute_heuristics(batch_states, batch_heuristics);
+    assert(batch_heuristics.size() == batch_states.size());
+
+    /*
+      We fill the heuristic cache right away, even for results that the
+      search never uses (e.g., because another evaluator of the open list
+      detects a dead end). Evaluating such a state again is then a cache
+      hit, which does not count as an evaluation.
+    */
+    for (size_t i = 0; i < batch_contexts.size(); ++i) {
+        int heuristic = batch_heuristics[i];
+        assert(heuristic == DEAD_END || heuristic >= 0);
+        if (cache_evaluator_values) {
+            heuristic_cache[batch_states[i]] = HEntry(heuristic, false);
+        }
+        EvaluationResult result;
+        result.set_count_evaluation(true);
+        result.set_evaluator_value(
+            heuristic == DEAD_END ? EvaluationResult::INFTY : heuristic);
+        batch_contexts[i]->set_result(this, move(result));
+    }
+}
+
 bool Heuristic::does_cache_estimates() const {
     return cache_evaluator_values;
 }
@@ -44,6 +44,10 @@ class Heuristic : public Evaluator {
       next, but this seems to be the only potential downside.
     */
     ordered_set::OrderedSet<OperatorID> preferred_operators;
+    // Reused by compute_batch_results.
+    std::vector<StateEvaluationContext *> batch_contexts;
+    std::vector<State> batch_states;
+    std::vector<int> batch_heuristics;
 
 protected:
     /*
@@ -64,6 +68,19 @@ protected:
 
     virtual int compute_heuristic(const State &ancestor_state) = 0;
 
+    /*
+      Heuristics that can share work between the states of a batch
+      override compute_results to call compute_batch_results. It passes
+      the states that need a value to compute_heuristics, which must
+      append their values to heuristics. Batches never ask for preferred
+      operators. The default implementation of compute_heuristics calls
+      compute_heuristic for each state and discards the preferred
+      operators it marks.
+    */
+    void compute_batch_results(std::vector<StateEvaluationContext> &batch);
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states, std::vector<int> &heuristics);
+
 
 
     /*
@@ -75,6 +92,19 @@ protected:
 
     State convert_ancestor_state(const State &ancestor_state) const;
 
+    /*
+      Return the packer of the registry of ancestor_state if its packed
+      data can be read as the data of the converted state, i.e., if
+      ancestor_state is registered and the task transformation of this
+      heuristic keeps state values. Otherwise, return nullptr and the
+      state has to be converted.
+    */
+    const int_packer::IntPacker *get_state_packer(
+        const State &ancestor_state) const;
+    // Like above, but only non-null if all states share the same registry.
+    const int_packer::IntPacker *get_state_packer(
+        const std::vector<State> &ancestor_states) const;
+
 public:
     explicit Heuristic(const options::Options &opts);
     virtual ~Heuristic() override;
@@ -6,6 +6,7 @@
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -13,12 +14,37 @@ using namespace std;
 
 namespace additive_heuristic {
 const int AdditiveHeuristic::MAX_COST_VALUE;
+const int AdditiveHeuristic::MAX_REPAIR_BACKOFF;
 
 // construction and destruction
 AdditiveHeuristic::AdditiveHeuristic(const Options &opts)
     : RelaxationHeuristic(opts),
-      did_write_overflow_warning(false) {
+      // The FF heuristic and the CEGAR code do not offer this option.
+      incremental(opts.get<bool>("incremental", false)),
+      did_write_overflow_warning(false),
+      costs_were_clamped(false),
+      repair_backoff(1),
+      num_evaluations_without_repair(0) {
     utils::g_log << "Initializing additive heuristic..." << endl;
+    if (incremental) {
+        build_achievers();
+        propagated_costs.resize(propositions.size(), -1);
+    }
+}
+
+void AdditiveHeuristic::build_achievers() {
+    int num_propositions = propositions.size();
+    vector<vector<OpID>> achiever_vectors(num_propositions);
+    int num_unary_ops = unary_operators.size();
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id)
+        achiever_vectors[unary_operators[op_id].effect].push_back(op_id);
+
+    achievers.reserve(num_propositions);
+    num_achievers.reserve(num_propositions);
+    for (const vector<OpID> &achiever_vector : achiever_vectors) {
+        achievers.push_back(achievers_pool.append(achiever_vector));
+        num_achievers.push_back(achiever_vector.size());
+    }
 }
 
 void AdditiveHeuristic::write_overflow_warning() {
@@ -36,19 +62,12 @@ void AdditiveHeuristic::write_overflow_warning() {
 // heuristic computation
 void AdditiveHeuristic::setup_exploration_queue() {
     queue.clear();
-
-    for (Proposition &prop : propositions) {
-        prop.cost = -1;
-        prop.marked = false;
-    }
+    reset_exploration_data();
 
     // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost, get_op_id(op));
+    for (OpID op_id : operators_without_preconditions) {
+        const UnaryOperator *op = get_operator(op_id);
+        enqueue_if_necessary(op->effect, op->base_cost, op_id);
     }
 }
 
@@ -59,7 +78,7 @@ void AdditiveHeuristic::setup_exploration_queue_state(const State &state) {
     }
 }
 
-void AdditiveHeuristic::relaxed_exploration() {
+void AdditiveHeuristic::relaxed_exploration(bool stop_at_goals) {
     int unsolved_goals = goal_propositions.size();
     while (!queue.empty()) {
         pair<int, PropID> top_pair = queue.pop();
@@ -71,17 +90,16 @@ void AdditiveHeuristic::relaxed_exploration() {
         assert(prop_cost <= distance);
         if (prop_cost < distance)
             continue;
-        if (prop->is_goal && --unsolved_goals == 0)
+        if (prop->is_goal && --unsolved_goals == 0 && stop_at_goals)
             return;
         for (OpID op_id : precondition_of_pool.get_slice(
                  prop->precondition_of, prop->num_precondition_occurences)) {
-            UnaryOperator *unary_op = get_operator(op_id);
-            increase_cost(unary_op->cost, prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect,
-                                     unary_op->cost, op_id);
+            UnaryOperatorStatus *status = get_operator_status(op_id);
+            increase_cost(status->cost, prop_cost);
+            --status->unsatisfied_preconditions;
+            assert(status->unsatisfied_preconditions >= 0);
+            if (status->unsatisfied_preconditions == 0)
+                enqueue_if_necessary(status->effect, status->cost, op_id);
         }
     }
 }
@@ -112,10 +130,165 @@ void AdditiveHeuristic::mark_preferred_operators(
     }
 }
 
+void AdditiveHeuristic::compute_costs_incrementally(const State &state) {
+    costs_were_clamped = false;
+    if (!previous_state_values.empty()) {
+        if (repair_exploration(state)) {
+            repair_backoff = 1;
+        } else {
+            previous_state_values.clear();
+            num_evaluations_without_repair = repair_backoff;
+            repair_backoff = min(2 * repair_backoff, MAX_REPAIR_BACKOFF);
+        }
+    }
+    if (previous_state_values.empty()) {
+        costs_were_clamped = false;
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        if (num_evaluations_without_repair > 0) {
+            --num_evaluations_without_repair;
+            relaxed_exploration(true);
+            return;
+        }
+        // We need all costs for the next repair.
+        relaxed_exploration(false);
+        int num_propositions = propositions.size();
+        for (PropID prop_id = 0; prop_id < num_propositions; ++prop_id)
+            propagated_costs[prop_id] = propositions[prop_id].cost;
+        previous_state_values.resize(task_proxy.get_variables().size());
+        for (FactProxy fact : state)
+            previous_state_values[fact.get_variable().get_id()] =
+                fact.get_value();
+    }
+    /*
+      The repair subtracts the costs of preconditions from the costs of
+      operators, which is wrong for clamped operator costs.
+    */
+    if (costs_were_clamped)
+        previous_state_values.clear();
+}
+
+bool AdditiveHeuristic::repair_exploration(const State &state) {
+    removed_facts.clear();
+    added_facts.clear();
+    for (FactProxy fact : state) {
+        int var = fact.get_variable().get_id();
+        int value = fact.get_value();
+        int &previous_value = previous_state_values[var];
+        if (value != previous_value) {
+            removed_facts.push_back(get_prop_id(var, previous_value));
+            added_facts.push_back(get_prop_id(fact));
+            previous_value = value;
+        }
+    }
+    if (!mark_affected_propositions())
+        return false;
+
+    for (Proposition &prop : propositions)
+        prop.marked = false;
+    queue.clear();
+    queue.add_virtual_pushes(propositions.size());
+    /*
+      The costs of unaffected propositions can only decrease. We explore
+      the affected part from scratch, starting with the costs of the
+      operators that achieve affected propositions and whose preconditions
+      are unaffected.
+    */
+    for (PropID prop_id : affected_propositions) {
+        for (OpID op_id : achievers_pool.get_slice(
+                 achievers[prop_id], num_achievers[prop_id])) {
+            const UnaryOperatorStatus *status = get_operator_status(op_id);
+            if (status->unsatisfied_preconditions == 0)
+                enqueue_if_necessary(prop_id, status->cost, op_id);
+        }
+    }
+    for (PropID prop_id : added_facts) {
+        enqueue_if_necessary(prop_id, 0, NO_OP);
+        // Facts of the state must not be marked as affected later.
+        get_proposition(prop_id)->reached_by = NO_OP;
+    }
+    propagate_changed_costs();
+    return !costs_were_clamped;
+}
+
+bool AdditiveHeuristic::mark_affected_propositions() {
+    /*
+      Removing the facts of the previous state can only increase costs. A
+      cost can increase if it comes from an operator with a precondition
+      whose cost can increase. We mark these propositions as unreached and
+      remove their costs from the operators they are preconditions of. We
+      give up if more than a quarter of the propositions are affected,
+      since the repair then takes longer than exploring from scratch.
+    */
+    size_t max_affected_propositions = propositions.size() / 4;
+    affected_propositions.assign(removed_facts.begin(), removed_facts.end());
+    for (size_t i = 0; i < affected_propositions.size(); ++i) {
+        PropID prop_id = affected_propositions[i];
+        Proposition *prop = get_proposition(prop_id);
+        int prop_cost = propagated_costs[prop_id];
+        assert(prop_cost != -1 && prop_cost == prop->cost);
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop->precondition_of, prop->num_precondition_occurences)) {
+            UnaryOperatorStatus *status = get_operator_status(op_id);
+            Proposition *effect = get_proposition(status->effect);
+            if (effect->reached_by == op_id) {
+                effect->reached_by = NO_OP;
+                affected_propositions.push_back(status->effect);
+                if (affected_propositions.size() > max_affected_propositions)
+                    return false;
+            }
+            status->cost -= prop_cost;
+            ++status->unsatisfied_preconditions;
+        }
+        prop->cost = -1;
+        prop->reached_by = NO_OP;
+        propagated_costs[prop_id] = -1;
+    }
+    return true;
+}
+
+void AdditiveHeuristic::propagate_changed_costs() {
+    /*
+      Like relaxed_exploration, but a popped proposition can already be
+      included in the costs of its operators with a higher cost.
+    */
+    while (!queue.empty()) {
+        pair<int, PropID> top_pair = queue.pop();
+        int distance = top_pair.first;
+        PropID prop_id = top_pair.second;
+        Proposition *prop = get_proposition(prop_id);
+        int prop_cost = prop->cost;
+        assert(prop_cost >= 0);
+        assert(prop_cost <= distance);
+        if (prop_cost < distance)
+            continue;
+        int previous_cost = propagated_costs[prop_id];
+        assert(previous_cost == -1 || previous_cost > prop_cost);
+        propagated_costs[prop_id] = prop_cost;
+        for (OpID op_id : precondition_of_pool.get_slice(
+                 prop->precondition_of, prop->num_precondition_occurences)) {
+            UnaryOperatorStatus *status = get_operator_status(op_id);
+            if (previous_cost == -1) {
+                increase_cost(status->cost, prop_cost);
+                --status->unsatisfied_preconditions;
+                assert(status->unsatisfied_preconditions >= 0);
+            } else {
+                status->cost -= previous_cost - prop_cost;
+            }
+            if (status->unsatisfied_preconditions == 0)
+                enqueue_if_necessary(status->effect, status->cost, op_id);
+        }
+    }
+}
+
 int AdditiveHeuristic::compute_add_and_ff(const State &state) {
-    setup_exploration_queue();
-    setup_exploration_queue_state(state);
-    relaxed_exploration();
+    if (incremental) {
+        compute_costs_incrementally(state);
+    } else {
+        setup_exploration_queue();
+        setup_exploration_queue_state(state);
+        relaxed_exploration(true);
+    }
 
     int total_cost = 0;
     for (PropID goal_id : goal_propositions) {
@@ -156,6 +329,19 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_property("safe", "yes for tasks without axioms");
     parser.document_property("preferred operators", "yes");
 
+    parser.add_option<bool>(
+        "incremental",
+        "compute the h^add values of each state by repairing those of the "
+        "previously evaluated state. This pays off for large tasks where "
+        "consecutively evaluated states (e.g., siblings in a best-first "
+        "search) only affect a small part of the relaxed task. If more than "
+        "a quarter of the propositions are affected, the state is explored "
+        "from scratch, and so are the next states, for a number of "
+        "evaluations that doubles with each failed repair (at most 64). "
+        "Heuristic values are identical to the non-incremental "
+        "computation, but preferred operators can differ if several "
+        "operators achieve a proposition at the same cost.",
+        "false");
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run())
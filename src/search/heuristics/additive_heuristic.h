@@ -7,6 +7,7 @@
 #include "../utils/collections.h"
 
 #include <cassert>
+#include <vector>
 
 class State;
 
@@ -18,6 +19,7 @@ using relaxation_heuristic::NO_OP;
 
 using relaxation_heuristic::Proposition;
 using relaxation_heuristic::UnaryOperator;
+using relaxation_heuristic::UnaryOperatorStatus;
 
 class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
     /* Costs larger than MAX_COST_VALUE are clamped to max_value. The
@@ -29,14 +31,53 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
      */
     static const int MAX_COST_VALUE = 100000000;
 
+    const bool incremental;
     priority_queues::AdaptiveQueue<PropID> queue;
     bool did_write_overflow_warning;
+    bool costs_were_clamped;
+
+    /*
+      In incremental mode, the exploration computes the costs of all
+      propositions, and the next exploration repairs them. Then
+      previous_state_values holds the state of the last exploration. It is
+      empty if the next state must be explored from scratch.
+    */
+    std::vector<int> previous_state_values;
+    /*
+      After a failed repair, the next repair_backoff evaluations explore
+      their states from scratch and stop once all goals are reached, like
+      the non-incremental computation. The back-off doubles with every
+      failed repair, up to MAX_REPAIR_BACKOFF, and is reset by a
+      successful repair. This limits the cost of the incremental mode in
+      tasks where consecutive states differ too much to be repaired.
+    */
+    static const int MAX_REPAIR_BACKOFF = 64;
+    int repair_backoff;
+    int num_evaluations_without_repair;
+    /*
+      The cost of each proposition that is included in the costs of the
+      operators it is a precondition of, or -1 if it is not included.
+      Outside of repairs, it equals the cost of the proposition.
+    */
+    std::vector<int> propagated_costs;
+    array_pool::ArrayPool achievers_pool;
+    std::vector<array_pool::ArrayPoolIndex> achievers;
+    std::vector<int> num_achievers;
+    std::vector<PropID> removed_facts;
+    std::vector<PropID> added_facts;
+    std::vector<PropID> affected_propositions;
 
     void setup_exploration_queue();
     void setup_exploration_queue_state(const State &state);
-    void relaxed_exploration();
+    void relaxed_exploration(bool stop_at_goals);
     void mark_preferred_operators(const State &state, PropID goal_id);
 
+    void build_achievers();
+    void compute_costs_incrementally(const State &state);
+    bool repair_exploration(const State &state);
+    bool mark_affected_propositions();
+    void propagate_changed_costs();
+
     void enqueue_if_necessary(PropID prop_id, int cost, OpID op_id) {
         assert(cost >= 0);
         Proposition *prop = get_proposition(prop_id);
@@ -55,6 +96,7 @@ class AdditiveHeuristic : public relaxation_heuristic::RelaxationHeuristic {
         if (cost > MAX_COST_VALUE) {
             write_overflow_warning();
             cost = MAX_COST_VALUE;
+            costs_were_clamped = true;
         }
     }
 
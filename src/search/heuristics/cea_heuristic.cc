@@ -7,7 +7,9 @@
 
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/memory.h"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <vector>
@@ -22,173 +24,114 @@ using namespace domain_transition_graph;
      is used to compute the costs of achieving all facts (v=d') for a
      fixed variable v starting from a fixed value d. So we can have at
      most |dom(v)| many local problems for any variable v. These are
-     created lazily as needed.
+     created lazily as needed and kept across evaluations.
    - LocalProblemNode: a single vertex in the domain transition graph
-     represented by a LocalProblem. Knows what the successors in the
-     graph are and keeps tracks of costs and helpful transitions for
-     the node.
+     represented by a LocalProblem. Keeps tracks of costs and helpful
+     transitions for the node.
    - LocalTransition: a transition between two local problem nodes.
      Keeps track of how many unachieved preconditions there still are,
      what the cost of enabling the transition are and things like that.
-
-   The following two design decisions might be worth revisiting:
-   - Each local problem keeps its own copy of the graph itself
-     (what is connected to what via which labels), even though this
-     is not necessary. The "static" graph info and the "dynamic" info
-     could be split, potentially saving quite a bit of memory.
-   - The graph is encoded with reference cycles: each transition knows
-     what its source node is, even though this is in a sense redundant
-     (the source must be the node which holds the transition), and
-     every node knows what its local problem is, which is similarly
-     redundant (the local problem must be the one that holds this node).
-     If we got rid of this, the main queue of the algorithm would need
-     (LocalProblem *, LocalProblemNode *) pairs rather than straight
-     node pointers, and the waiting lists would need to contain
-     (LocalProblemNode *, LocalTransition *) pairs rather than straight
-     transitions. So it's not clear if this would really save much, which
-     is why we do not currently do it.
+   - LocalProblemGraph: the "static" graph info (what is connected to
+     what via which labels), which all local problems of a variable
+     share.
+
+   The nodes, transitions and contexts of all local problems
+   are stored in pooled vectors and referred to by index. The nodes of a
+   local problem are consecutive, so the node for value d of local problem
+   p has index first_node(p) + d, and likewise for transitions. Since
+   creating a local problem can reallocate the pools, code that creates
+   local problems must not hold references into them.
+
+   When a node is expanded, we first check for each arc leaving it
+   whether it can lead to a cheaper path to its target. Most of these
+   checks fail, and they only touch the arcs of the graph and the target
+   nodes, not the transitions.
  */
 namespace cea_heuristic {
-struct LocalTransition {
-    LocalProblemNode *source;
-    LocalProblemNode *target;
-    const ValueTransitionLabel *label;
-    int action_cost;
-
-    int target_cost;
-    int unreached_conditions;
-
-    LocalTransition(
-        LocalProblemNode *source_, LocalProblemNode *target_,
-        const ValueTransitionLabel *label_, int action_cost_)
-        : source(source_), target(target_),
-          label(label_), action_cost(action_cost_),
-          target_cost(-1), unreached_conditions(-1) {
-        // target_cost and unreached_cost are initialized by
-        // expand_transition.
-    }
-
-    ~LocalTransition() {
-    }
-};
-
-
-struct LocalProblemNode {
-    // Attributes fixed during initialization.
-    LocalProblem *owner;
-    vector<LocalTransition> outgoing_transitions;
-
-    // Dynamic attributes (modified during heuristic computation).
-    int cost;
-    bool expanded;
-    vector<short> context;
-
-    LocalTransition *reached_by;
-    /* Before a node is expanded, reached_by is the "current best"
-       transition leading to this node. After a node is expanded, the
-       reached_by value of the parent is copied (unless the parent is
-       the initial node), so that reached_by is the *first* transition
-       on the optimal path to this node. This is useful for preferred
-       operators. (The two attributes used to be separate, but this
-       was a bit wasteful.) */
-
-    vector<LocalTransition *> waiting_list;
-
-    LocalProblemNode(LocalProblem *owner_, int context_size)
-        : owner(owner_),
-          cost(-1),
-          expanded(false),
-          context(context_size, -1),
-          reached_by(0) {
-    }
-
-    ~LocalProblemNode() {
-    }
-};
-
-struct LocalProblem {
-    int base_priority;
-    vector<LocalProblemNode> nodes;
-    vector<int> *context_variables;
-public:
-    LocalProblem()
-        : base_priority(-1) {
-    }
-
-    ~LocalProblem() {
-    }
-};
-
-LocalProblem *ContextEnhancedAdditiveHeuristic::get_local_problem(
-    int var_no, int value) {
-    LocalProblem * &table_entry = local_problem_index[var_no][value];
-    if (!table_entry) {
-        table_entry = build_problem_for_variable(var_no);
-        local_problems.push_back(table_entry);
-    }
-    return table_entry;
-}
-
-LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_variable(
-    int var_no) const {
-    LocalProblem *problem = new LocalProblem;
-
-    DomainTransitionGraph *dtg = transition_graphs[var_no].get();
-
-    problem->context_variables = &dtg->local_to_global_child;
-
-    int num_parents = problem->context_variables->size();
-    size_t num_values = task_proxy.get_variables()[var_no].get_domain_size();
-    problem->nodes.reserve(num_values);
-    for (size_t value = 0; value < num_values; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, num_parents));
-
-    // Compile the DTG arcs into LocalTransition objects.
+void ContextEnhancedAdditiveHeuristic::build_graph(
+    const DomainTransitionGraph &dtg) {
+    graphs.emplace_back();
+    LocalProblemGraph &graph = graphs.back();
+    graph.context_variables = &dtg.local_to_global_child;
+
+    // Compile the DTG arcs into LocalArc objects.
+    size_t num_values = dtg.nodes.size();
+    graph.first_arc.reserve(num_values + 1);
     for (size_t value = 0; value < num_values; ++value) {
-        LocalProblemNode &node = problem->nodes[value];
-        const ValueNode &dtg_node = dtg->nodes[value];
-        for (size_t i = 0; i < dtg_node.transitions.size(); ++i) {
-            const ValueTransition &dtg_trans = dtg_node.transitions[i];
+        graph.first_arc.push_back(graph.arcs.size());
+        const ValueNode &dtg_node = dtg.nodes[value];
+        for (const ValueTransition &dtg_trans : dtg_node.transitions) {
             int target_value = dtg_trans.target->value;
-            LocalProblemNode &target = problem->nodes[target_value];
             for (const ValueTransitionLabel &label : dtg_trans.labels) {
                 OperatorProxy op = label.is_axiom ?
                     task_proxy.get_axioms()[label.op_id] :
                     task_proxy.get_operators()[label.op_id];
-                LocalTransition trans(&node, &target, &label, op.get_cost());
-                node.outgoing_transitions.push_back(trans);
+                graph.arcs.push_back({target_value, op.get_cost()});
+                graph.labels.push_back(&label);
             }
         }
     }
-    return problem;
+    graph.first_arc.push_back(graph.arcs.size());
 }
 
-LocalProblem *ContextEnhancedAdditiveHeuristic::build_problem_for_goal() const {
-    LocalProblem *problem = new LocalProblem;
-
+void ContextEnhancedAdditiveHeuristic::build_goal_graph() {
     GoalsProxy goals_proxy = task_proxy.get_goals();
 
-    problem->context_variables = new vector<int>;
-    for (FactProxy goal : goals_proxy)
-        problem->context_variables->push_back(goal.get_variable().get_id());
-
-    for (size_t value = 0; value < 2; ++value)
-        problem->nodes.push_back(LocalProblemNode(problem, goals_proxy.size()));
-
     vector<LocalAssignment> goals;
     for (size_t goal_no = 0; goal_no < goals_proxy.size(); ++goal_no) {
+        goal_variables.push_back(goals_proxy[goal_no].get_variable().get_id());
         int goal_value = goals_proxy[goal_no].get_value();
         goals.push_back(LocalAssignment(goal_no, goal_value));
     }
     vector<LocalAssignment> no_effects;
-    ValueTransitionLabel *label = new ValueTransitionLabel(0, true, goals, no_effects);
-    LocalTransition trans(&problem->nodes[0], &problem->nodes[1], label, 0);
-    problem->nodes[0].outgoing_transitions.push_back(trans);
-    return problem;
+    goal_label = utils::make_unique_ptr<ValueTransitionLabel>(
+        0, true, goals, no_effects);
+
+    graphs.emplace_back();
+    LocalProblemGraph &graph = graphs.back();
+    graph.context_variables = &goal_variables;
+    graph.first_arc = {0, 1, 1};
+    graph.arcs.push_back({1, 0});
+    graph.labels.push_back(goal_label.get());
 }
 
-int ContextEnhancedAdditiveHeuristic::get_priority(
-    LocalProblemNode *node) const {
+int ContextEnhancedAdditiveHeuristic::build_local_problem(int graph_id) {
+    const LocalProblemGraph &graph = graphs[graph_id];
+    int problem_id = local_problems.size();
+    int first_node = nodes.size();
+    int first_transition = transitions.size();
+    int num_context_variables = graph.context_variables->size();
+    local_problems.push_back(
+        {graph_id, num_context_variables, -1, first_node, first_transition});
+
+    int num_values = graph.get_num_values();
+    for (int value = 0; value < num_values; ++value) {
+        nodes.push_back({problem_id, static_cast<int>(contexts.size()),
+                         -1, -1, false, -1, {}});
+        contexts.resize(contexts.size() + num_context_variables, -1);
+    }
+
+    for (int value = 0; value < num_values; ++value) {
+        for (int arc_id = graph.first_arc[value];
+             arc_id < graph.first_arc[value + 1]; ++arc_id) {
+            const LocalArc &arc = graph.arcs[arc_id];
+            transitions.push_back(
+                {first_node + value, first_node + arc.target_value,
+                 graph.labels[arc_id], arc.action_cost, -1, -1});
+        }
+    }
+    return problem_id;
+}
+
+int ContextEnhancedAdditiveHeuristic::get_local_problem(
+    int var_no, int value) {
+    int &table_entry = local_problem_index[var_no][value];
+    if (table_entry == -1)
+        table_entry = build_local_problem(var_no);
+    return table_entry;
+}
+
+int ContextEnhancedAdditiveHeuristic::get_priority(int node_id) const {
     /* Nodes have both a "cost" and a "priority", which are related.
        The cost is an estimate of how expensive it is to reach this
        node. The "priority" is the lowest cost value in the overall
@@ -196,174 +139,207 @@ int ContextEnhancedAdditiveHeuristic::get_priority(
        essentially the sum of the cost and a local-problem-specific
        "base priority", which depends on where this local problem is
        needed for the overall computation. */
-    return node->owner->base_priority + node->cost;
+    return nodes[node_id].base_priority + nodes[node_id].cost;
 }
 
 inline void ContextEnhancedAdditiveHeuristic::initialize_heap() {
     node_queue.clear();
 }
 
-inline void ContextEnhancedAdditiveHeuristic::add_to_heap(
-    LocalProblemNode *node) {
-    node_queue.push(get_priority(node), node);
+inline void ContextEnhancedAdditiveHeuristic::add_to_heap(int node_id) {
+    node_queue.push(get_priority(node_id), node_id);
 }
 
 bool ContextEnhancedAdditiveHeuristic::is_local_problem_set_up(
-    const LocalProblem *problem) const {
-    return problem->base_priority != -1;
+    int problem_id) const {
+    return local_problems[problem_id].base_priority != -1;
 }
 
 void ContextEnhancedAdditiveHeuristic::set_up_local_problem(
-    LocalProblem *problem, int base_priority,
+    int problem_id, int base_priority,
     int start_value, const State &state) {
-    assert(problem->base_priority == -1);
-    problem->base_priority = base_priority;
-
-    for (auto &to_node : problem->nodes) {
-        to_node.expanded = false;
-        to_node.cost = numeric_limits<int>::max();
-        to_node.waiting_list.clear();
-        to_node.reached_by = 0;
+    LocalProblem &problem = local_problems[problem_id];
+    assert(problem.base_priority == -1);
+    problem.base_priority = base_priority;
+
+    const LocalProblemGraph &graph = graphs[problem.graph_id];
+    int end_node = problem.first_node + graph.get_num_values();
+    for (int node_id = problem.first_node; node_id < end_node; ++node_id) {
+        LocalProblemNode &node = nodes[node_id];
+        node.base_priority = base_priority;
+        node.expanded = false;
+        node.cost = numeric_limits<int>::max();
+        node.waiting_list.clear();
+        node.reached_by = -1;
     }
 
-    LocalProblemNode *start = &problem->nodes[start_value];
-    start->cost = 0;
-    for (size_t i = 0; i < problem->context_variables->size(); ++i)
-        start->context[i] = state[(*problem->context_variables)[i]].get_value();
+    int start = problem.first_node + start_value;
+    nodes[start].cost = 0;
+    const vector<int> &context_variables = *graph.context_variables;
+    short *context = contexts.data() + nodes[start].context;
+    for (size_t i = 0; i < context_variables.size(); ++i)
+        context[i] = state[context_variables[i]].get_value();
 
     add_to_heap(start);
 }
 
+void ContextEnhancedAdditiveHeuristic::add_to_waiting_list(
+    int node_id, int transition_id) {
+    nodes[node_id].waiting_list.push_back(transition_id);
+}
+
 void ContextEnhancedAdditiveHeuristic::try_to_fire_transition(
-    LocalTransition *trans) {
-    if (!trans->unreached_conditions) {
-        LocalProblemNode *target = trans->target;
-        if (trans->target_cost < target->cost) {
-            target->cost = trans->target_cost;
-            target->reached_by = trans;
+    int transition_id) {
+    const LocalTransition &trans = transitions[transition_id];
+    if (!trans.unreached_conditions) {
+        int target = trans.target;
+        if (trans.target_cost < nodes[target].cost) {
+            nodes[target].cost = trans.target_cost;
+            nodes[target].reached_by = transition_id;
             add_to_heap(target);
         }
     }
 }
 
-void ContextEnhancedAdditiveHeuristic::expand_node(LocalProblemNode *node) {
-    node->expanded = true;
+void ContextEnhancedAdditiveHeuristic::expand_node(int node_id) {
+    LocalProblemNode &node = nodes[node_id];
+    node.expanded = true;
     // Set context unless this was an initial node.
-    LocalTransition *reached_by = node->reached_by;
-    if (reached_by) {
-        LocalProblemNode *parent = reached_by->source;
-        vector<short> &context = node->context;
-        context = parent->context;
-        const vector<LocalAssignment> &precond = reached_by->label->precond;
-        for (size_t i = 0; i < precond.size(); ++i)
-            context[precond[i].local_var] = precond[i].value;
-        const vector<LocalAssignment> &effect = reached_by->label->effect;
-        for (size_t i = 0; i < effect.size(); ++i)
-            context[effect[i].local_var] = effect[i].value;
-        if (parent->reached_by)
-            node->reached_by = parent->reached_by;
+    if (node.reached_by != -1) {
+        const LocalTransition &reached_by = transitions[node.reached_by];
+        const LocalProblemNode &parent = nodes[reached_by.source];
+        int num_context_variables =
+            local_problems[node.problem_id].num_context_variables;
+        short *context = contexts.data() + node.context;
+        copy_n(contexts.data() + parent.context, num_context_variables, context);
+        for (const LocalAssignment &precond : reached_by.label->precond)
+            context[precond.local_var] = precond.value;
+        for (const LocalAssignment &effect : reached_by.label->effect)
+            context[effect.local_var] = effect.value;
+        if (parent.reached_by != -1)
+            node.reached_by = parent.reached_by;
     }
-    for (size_t i = 0; i < node->waiting_list.size(); ++i) {
-        LocalTransition *trans = node->waiting_list[i];
-        assert(trans->unreached_conditions);
-        --trans->unreached_conditions;
-        trans->target_cost += node->cost;
-        try_to_fire_transition(trans);
+    int node_cost = node.cost;
+    for (int transition_id : node.waiting_list) {
+        LocalTransition &trans = transitions[transition_id];
+        assert(trans.unreached_conditions);
+        --trans.unreached_conditions;
+        trans.target_cost += node_cost;
+        try_to_fire_transition(transition_id);
     }
-    node->waiting_list.clear();
+    node.waiting_list.clear();
 }
 
 void ContextEnhancedAdditiveHeuristic::expand_transition(
-    LocalTransition *trans, const State &state) {
-    /* Called when the source of trans is reached by Dijkstra
-       exploration. Try to compute cost for the target of the
-       transition from the source cost, action cost, and set-up costs
-       for the conditions on the label. The latter may yet be unknown,
-       in which case we "subscribe" to the waiting list of the node
-       that will tell us the correct value. */
-
-    assert(trans->source->cost >= 0);
-    assert(trans->source->cost < numeric_limits<int>::max());
-
-    trans->target_cost = trans->source->cost + trans->action_cost;
-
-    if (trans->target->cost <= trans->target_cost) {
-        // Transition cannot find a shorter path to target.
-        return;
-    }
-
-    trans->unreached_conditions = 0;
-    const vector<LocalAssignment> &precond = trans->label->precond;
-
-    vector<LocalAssignment>::const_iterator
-        curr_precond = precond.begin(),
-        last_precond = precond.end();
-
-    vector<short>::const_iterator context = trans->source->context.begin();
-    vector<int>::const_iterator parent_vars =
-        trans->source->owner->context_variables->begin();
-
-    for (; curr_precond != last_precond; ++curr_precond) {
-        int local_var = curr_precond->local_var;
-        int current_val = context[local_var];
-        int precond_value = curr_precond->value;
-        int precond_var_no = parent_vars[local_var];
+    int transition_id, const ValueTransitionLabel &label,
+    const vector<int> &context_variables, int source_context,
+    int source_priority, int target, int target_cost, const State &state) {
+    /* Called when the source of the transition is reached by Dijkstra
+       exploration and the sum of the source cost and the action cost
+       (target_cost) is lower than the cost of the target. Try to compute
+       cost for the target of the transition from this sum and set-up
+       costs for the conditions on the label. The latter may yet be
+       unknown, in which case we "subscribe" to the waiting list of the
+       node that will tell us the correct value.
+
+       The caller passes the data of the source node, which is the same
+       for all transitions leaving it. Getting a local problem can
+       reallocate the pools, so we only access them by index here. */
+    assert(target_cost < nodes[target].cost);
+    int unreached_conditions = 0;
+    for (const LocalAssignment &assignment : label.precond) {
+        int local_var = assignment.local_var;
+        int current_val = contexts[source_context + local_var];
+        int precond_value = assignment.value;
 
         if (current_val == precond_value)
             continue;
 
-        LocalProblem *subproblem = get_local_problem(
-            precond_var_no, current_val);
+        int subproblem = get_local_problem(
+            context_variables[local_var], current_val);
 
         if (!is_local_problem_set_up(subproblem)) {
             set_up_local_problem(
-                subproblem, get_priority(trans->source), current_val, state);
+                subproblem, source_priority, current_val, state);
         }
 
-        LocalProblemNode *cond_node = &subproblem->nodes[precond_value];
-        if (cond_node->expanded) {
-            trans->target_cost += cond_node->cost;
-            if (trans->target->cost <= trans->target_cost) {
+        int cond_node = local_problems[subproblem].first_node + precond_value;
+        if (nodes[cond_node].expanded) {
+            target_cost += nodes[cond_node].cost;
+            if (nodes[target].cost <= target_cost) {
                 // Transition cannot find a shorter path to target.
+                transitions[transition_id].target_cost = target_cost;
+                transitions[transition_id].unreached_conditions =
+                    unreached_conditions;
                 return;
             }
         } else {
-            cond_node->waiting_list.push_back(trans);
-            ++trans->unreached_conditions;
+            add_to_waiting_list(cond_node, transition_id);
+            ++unreached_conditions;
         }
     }
-    try_to_fire_transition(trans);
+    transitions[transition_id].target_cost = target_cost;
+    transitions[transition_id].unreached_conditions = unreached_conditions;
+    try_to_fire_transition(transition_id);
 }
 
 int ContextEnhancedAdditiveHeuristic::compute_costs(const State &state) {
     while (!node_queue.empty()) {
-        pair<int, LocalProblemNode *> top_pair = node_queue.pop();
+        pair<int, int> top_pair = node_queue.pop();
         int curr_priority = top_pair.first;
-        LocalProblemNode *node = top_pair.second;
+        int node_id = top_pair.second;
 
-        assert(is_local_problem_set_up(node->owner));
-        if (get_priority(node) < curr_priority)
+        assert(is_local_problem_set_up(nodes[node_id].problem_id));
+        if (get_priority(node_id) < curr_priority)
             continue;
-        if (node == goal_node)
-            return node->cost;
-
-        assert(get_priority(node) == curr_priority);
-        expand_node(node);
-        for (auto &transition : node->outgoing_transitions)
-            expand_transition(&transition, state);
+        if (node_id == goal_node)
+            return nodes[node_id].cost;
+
+        assert(get_priority(node_id) == curr_priority);
+        expand_node(node_id);
+
+        /*
+          Expanding transitions does not change the cost of the expanded
+          node, but it can reallocate the pools.
+        */
+        const LocalProblemNode &node = nodes[node_id];
+        const LocalProblem &problem = local_problems[node.problem_id];
+        int first_node = problem.first_node;
+        int first_transition = problem.first_transition;
+        const LocalProblemGraph &graph = graphs[problem.graph_id];
+        int value = node_id - first_node;
+        int node_cost = node.cost;
+        int node_context = node.context;
+        int node_priority = get_priority(node_id);
+        int end_arc = graph.first_arc[value + 1];
+        for (int arc_id = graph.first_arc[value]; arc_id < end_arc; ++arc_id) {
+            const LocalArc &arc = graph.arcs[arc_id];
+            int target = first_node + arc.target_value;
+            int target_cost = node_cost + arc.action_cost;
+            if (nodes[target].cost <= target_cost) {
+                // Transition cannot find a shorter path to target.
+                continue;
+            }
+            expand_transition(first_transition + arc_id, *graph.labels[arc_id],
+                              *graph.context_variables, node_context,
+                              node_priority, target, target_cost, state);
+        }
     }
     return DEAD_END;
 }
 
 void ContextEnhancedAdditiveHeuristic::mark_helpful_transitions(
-    LocalProblem *problem, LocalProblemNode *node, const State &state) {
-    assert(node->cost >= 0 && node->cost < numeric_limits<int>::max());
-    LocalTransition *first_on_path = node->reached_by;
-    if (first_on_path) {
-        node->reached_by = 0; // Clear to avoid revisiting this node later.
-        if (first_on_path->target_cost == first_on_path->action_cost) {
+    int problem_id, int node_id, const State &state) {
+    assert(nodes[node_id].cost >= 0 &&
+           nodes[node_id].cost < numeric_limits<int>::max());
+    int first_on_path_id = nodes[node_id].reached_by;
+    if (first_on_path_id != -1) {
+        // Clear to avoid revisiting this node later.
+        nodes[node_id].reached_by = -1;
+        const LocalTransition &first_on_path = transitions[first_on_path_id];
+        if (first_on_path.target_cost == first_on_path.action_cost) {
             // Transition possibly applicable.
-            const ValueTransitionLabel &label = *first_on_path->label;
+            const ValueTransitionLabel &label = *first_on_path.label;
             OperatorProxy op = label.is_axiom ?
                 task_proxy.get_axioms()[label.op_id] :
                 task_proxy.get_operators()[label.op_id];
@@ -375,16 +351,18 @@ void ContextEnhancedAdditiveHeuristic::mark_helpful_transitions(
             }
         } else {
             // Recursively compute helpful transitions for preconditions.
-            int *context_vars = &*problem->context_variables->begin();
-            for (const auto &assignment : first_on_path->label->precond) {
+            const LocalProblem &problem = local_problems[problem_id];
+            const vector<int> &context_vars =
+                *graphs[problem.graph_id].context_variables;
+            for (const auto &assignment : first_on_path.label->precond) {
                 int precond_value = assignment.value;
                 int local_var = assignment.local_var;
                 int precond_var_no = context_vars[local_var];
-                if (state[precond_var_no].get_value() == precond_value)
+                int current_value = state[precond_var_no].get_value();
+                if (current_value == precond_value)
                     continue;
-                LocalProblem *subproblem = get_local_problem(
-                    precond_var_no, state[precond_var_no].get_value());
-                LocalProblemNode *subnode = &subproblem->nodes[precond_value];
+                int subproblem = get_local_problem(precond_var_no, current_value);
+                int subnode = local_problems[subproblem].first_node + precond_value;
                 mark_helpful_transitions(subproblem, subnode, state);
             }
         }
@@ -395,9 +373,8 @@ int ContextEnhancedAdditiveHeuristic::compute_heuristic(
     const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     initialize_heap();
-    goal_problem->base_priority = -1;
-    for (LocalProblem *problem : local_problems)
-        problem->base_priority = -1;
+    for (LocalProblem &problem : local_problems)
+        problem.base_priority = -1;
 
     set_up_local_problem(goal_problem, 0, 0, state);
 
@@ -418,24 +395,18 @@ ContextEnhancedAdditiveHeuristic::ContextEnhancedAdditiveHeuristic(
     DTGFactory factory(task_proxy, true, [](int, int) {return false;});
     transition_graphs = factory.build_dtgs();
 
-    goal_problem = build_problem_for_goal();
-    goal_node = &goal_problem->nodes[1];
+    graphs.reserve(transition_graphs.size() + 1);
+    for (const auto &dtg : transition_graphs)
+        build_graph(*dtg);
+    build_goal_graph();
+
+    goal_problem = build_local_problem(graphs.size() - 1);
+    goal_node = local_problems[goal_problem].first_node + 1;
 
     VariablesProxy vars = task_proxy.get_variables();
     local_problem_index.resize(vars.size());
     for (VariableProxy var : vars)
-        local_problem_index[var.get_id()].resize(var.get_domain_size(), 0);
-}
-
-ContextEnhancedAdditiveHeuristic::~ContextEnhancedAdditiveHeuristic() {
-    if (goal_problem) {
-        delete goal_problem->context_variables;
-        delete goal_problem->nodes[0].outgoing_transitions[0].label;
-    }
-    delete goal_problem;
-
-    for (LocalProblem *problem : local_problems)
-        delete problem;
+        local_problem_index[var.get_id()].resize(var.get_domain_size(), -1);
 }
 
 bool ContextEnhancedAdditiveHeuristic::dead_ends_are_reliable() const {
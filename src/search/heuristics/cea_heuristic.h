@@ -7,51 +7,139 @@
 
 #include "../algorithms/priority_queues.h"
 
+#include <memory>
 #include <vector>
 
 class State;
 
 namespace cea_heuristic {
-struct LocalProblem;
-struct LocalProblemNode;
-struct LocalTransition;
+/*
+  The part of a transition that is checked for every transition leaving
+  an expanded node. Most checks fail, so we keep this part apart from the
+  other data of the transition.
+*/
+struct LocalArc {
+    int target_value;
+    int action_cost;
+};
+
+/*
+  A domain transition graph in the form needed for local problems. All
+  local problems of a variable share it. The arcs leaving value d are
+  arcs[first_arc[d]], ..., arcs[first_arc[d + 1] - 1].
+*/
+struct LocalProblemGraph {
+    const std::vector<int> *context_variables;
+    std::vector<int> first_arc;
+    std::vector<LocalArc> arcs;
+    std::vector<const domain_transition_graph::ValueTransitionLabel *> labels;
+
+    int get_num_values() const {
+        return first_arc.size() - 1;
+    }
+};
+
+struct LocalProblem {
+    int graph_id;
+    int num_context_variables;
+    int base_priority;
+    int first_node;
+    // The transition for arc i of the graph has ID first_transition + i.
+    int first_transition;
+};
+
+struct LocalProblemNode {
+    // Attributes fixed during initialization.
+    int problem_id;
+    // The context of the node starts at this index of the context pool.
+    int context;
+
+    // Dynamic attributes (modified during heuristic computation).
+    // Copy of the base priority of the local problem.
+    int base_priority;
+    int cost;
+    bool expanded;
+    /* Before a node is expanded, reached_by is the "current best"
+       transition leading to this node. After a node is expanded, the
+       reached_by value of the parent is copied (unless the parent is
+       the initial node), so that reached_by is the *first* transition
+       on the optimal path to this node. This is useful for preferred
+       operators. (The two attributes used to be separate, but this
+       was a bit wasteful.) -1 means no transition. */
+    int reached_by;
+    std::vector<int> waiting_list;
+};
+
+struct LocalTransition {
+    // Attributes fixed during initialization.
+    int source;
+    int target;
+    const domain_transition_graph::ValueTransitionLabel *label;
+    int action_cost;
+
+    // Dynamic attributes, initialized by expand_transition.
+    int target_cost;
+    int unreached_conditions;
+};
 
 class ContextEnhancedAdditiveHeuristic : public Heuristic {
     std::vector<std::unique_ptr<domain_transition_graph::DomainTransitionGraph>> transition_graphs;
-    std::vector<LocalProblem *> local_problems;
-    std::vector<std::vector<LocalProblem *>> local_problem_index;
-    LocalProblem *goal_problem;
-    LocalProblemNode *goal_node;
+    std::vector<int> goal_variables;
+    std::unique_ptr<domain_transition_graph::ValueTransitionLabel> goal_label;
+    // One graph per variable, followed by the graph of the goal problem.
+    std::vector<LocalProblemGraph> graphs;
+
+    /*
+      Local problems are created lazily and kept across evaluations. The
+      data of their nodes and transitions is pooled in the vectors below
+      and referred to by index, because the vectors grow when new local
+      problems are created.
+    */
+    std::vector<LocalProblem> local_problems;
+    // ID of the local problem for (var, value), or -1 if not created yet.
+    std::vector<std::vector<int>> local_problem_index;
+    std::vector<LocalProblemNode> nodes;
+    std::vector<LocalTransition> transitions;
+    std::vector<short> contexts;
+
+    int goal_problem;
+    int goal_node;
     int min_action_cost;
 
-    priority_queues::AdaptiveQueue<LocalProblemNode *> node_queue;
+    priority_queues::AdaptiveQueue<int> node_queue;
 
-    LocalProblem *get_local_problem(int var_no, int value);
-    LocalProblem *build_problem_for_variable(int var_no) const;
-    LocalProblem *build_problem_for_goal() const;
+    void build_graph(const domain_transition_graph::DomainTransitionGraph &dtg);
+    void build_goal_graph();
+    int build_local_problem(int graph_id);
+    int get_local_problem(int var_no, int value);
 
-    int get_priority(LocalProblemNode *node) const;
+    int get_priority(int node_id) const;
     void initialize_heap();
-    void add_to_heap(LocalProblemNode *node);
+    void add_to_heap(int node_id);
 
-    bool is_local_problem_set_up(const LocalProblem *problem) const;
-    void set_up_local_problem(LocalProblem *problem, int base_priority,
+    bool is_local_problem_set_up(int problem_id) const;
+    void set_up_local_problem(int problem_id, int base_priority,
                               int start_value, const State &state);
 
-    void try_to_fire_transition(LocalTransition *trans);
-    void expand_node(LocalProblemNode *node);
-    void expand_transition(LocalTransition *trans, const State &state);
+    void add_to_waiting_list(int node_id, int transition_id);
+    void try_to_fire_transition(int transition_id);
+    void expand_node(int node_id);
+    void expand_transition(
+        int transition_id,
+        const domain_transition_graph::ValueTransitionLabel &label,
+        const std::vector<int> &context_variables, int source_context,
+        int source_priority, int target, int target_cost,
+        const State &state);
 
     int compute_costs(const State &state);
     void mark_helpful_transitions(
-        LocalProblem *problem, LocalProblemNode *node, const State &state);
+        int problem_id, int node_id, const State &state);
     // Clears "reached_by" of visited nodes as a side effect to avoid
     // recursing to the same node again.
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit ContextEnhancedAdditiveHeuristic(const options::Options &opts);
-    ~ContextEnhancedAdditiveHeuristic();
     virtual bool dead_ends_are_reliable() const override;
 };
 }
@@ -5,264 +5,463 @@
 
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <iterator>
 #include <limits>
-#include <set>
 
 using namespace std;
 
 namespace hm_heuristic {
+/*
+  Call callback(subset) for all subsets of at most max_size of the given
+  sorted facts that extend subset with facts at positions >= start.
+  The subsets are sorted and include subset itself.
+*/
+template<typename Callback>
+static void for_each_subset(
+    const vector<int> &facts, int max_size, vector<int> &subset,
+    size_t start, const Callback &callback) {
+    callback(subset);
+    if (static_cast<int>(subset.size()) == max_size) {
+        return;
+    }
+    for (size_t i = start; i < facts.size(); ++i) {
+        subset.push_back(facts[i]);
+        for_each_subset(facts, max_size, subset, i + 1, callback);
+        subset.pop_back();
+    }
+}
+
 HMHeuristic::HMHeuristic(const Options &opts)
     : Heuristic(opts),
       m(opts.get<int>("m")),
       has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
-      goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
+      num_variables(task_proxy.get_variables().size()),
+      num_facts(0),
+      num_contexts(0),
+      num_goal_tuples(0) {
     utils::g_log << "Using h^" << m << "." << endl;
-    utils::g_log << "The implementation of the h^m heuristic is preliminary." << endl
-                 << "It is SLOOOOOOOOOOOW." << endl
-                 << "Please do not use this for comparison!" << endl;
-    generate_all_tuples();
-}
-
-
-bool HMHeuristic::dead_ends_are_reliable() const {
-    return !task_properties::has_axioms(task_proxy) && !has_cond_effects;
-}
-
-
-int HMHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-    if (task_properties::is_goal_state(task_proxy, state)) {
-        return 0;
-    } else {
-        Tuple s_tup = task_properties::get_fact_pairs(state);
-
-        init_hm_table(s_tup);
-        update_hm_table();
-
-        int h = eval(goals);
-
-        if (h == numeric_limits<int>::max())
-            return DEAD_END;
-        return h;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        variable_offsets.push_back(num_facts);
+        num_facts += var.get_domain_size();
+        fact_to_variable.resize(num_facts, var.get_id());
     }
+    variable_offsets.push_back(num_facts);
+
+    compute_binomials();
+    build_operators();
+    build_goal_tuples();
+    tuple_costs.assign(tuple_offsets[m + 1], -1);
+    counters.resize(num_contexts);
+    context_reached.resize(num_contexts, false);
+    // Every reached operator needs the counter of the empty context.
+    counters[0].assign(operators.size(), 0);
+    pending_contexts.resize(operators.size());
+    utils::g_log << "Number of tuples: " << tuple_offsets[m + 1] << endl;
 }
 
+void HMHeuristic::compute_binomials() {
+    /*
+      We compute the values with saturation at limit + 1 to detect that
+      the tuple IDs would not fit into an int.
+    */
+    const int64_t limit = numeric_limits<int>::max();
+    vector<vector<int64_t>> values(m + 1, vector<int64_t>(num_facts + 1, 0));
+    for (int n = 0; n <= num_facts; ++n) {
+        values[0][n] = 1;
+        for (int k = 1; k <= m && n > 0; ++k) {
+            values[k][n] = min(limit + 1, values[k - 1][n - 1] + values[k][n - 1]);
+        }
+    }
+    vector<int64_t> offsets(1, 0);
+    for (int k = 0; k <= m; ++k) {
+        offsets.push_back(min(limit + 1, offsets.back() + values[k][num_facts]));
+    }
+    if (offsets.back() > limit) {
+        cerr << "h^" << m << " would need more than " << limit
+             << " tuples for " << num_facts << " facts." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+    }
 
-void HMHeuristic::init_hm_table(const Tuple &t) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        int h_val = check_tuple_in_tuple(tuple, t);
-        hm_table[tuple] = h_val;
+    binomials.resize(m + 1);
+    for (int k = 0; k <= m; ++k) {
+        binomials[k].assign(values[k].begin(), values[k].end());
     }
+    tuple_offsets.assign(offsets.begin(), offsets.end());
+    num_contexts = tuple_offsets[m];
 }
 
-
-void HMHeuristic::update_hm_table() {
-    int round = 0;
-    do {
-        ++round;
-        was_updated = false;
-
-        for (OperatorProxy op : task_proxy.get_operators()) {
-            Tuple pre = get_operator_pre(op);
-
-            int c1 = eval(pre);
-            if (c1 != numeric_limits<int>::max()) {
-                Tuple eff = get_operator_eff(op);
-                vector<Tuple> partial_effs;
-                generate_all_partial_tuples(eff, partial_effs);
-                for (Tuple &partial_eff : partial_effs) {
-                    update_hm_entry(partial_eff, c1 + op.get_cost());
-
-                    int eff_size = partial_eff.size();
-                    if (eff_size < m) {
-                        extend_tuple(partial_eff, op);
-                    }
-                }
-            }
+void HMHeuristic::build_operators() {
+    OperatorsProxy task_operators = task_proxy.get_operators();
+    int num_operators = task_operators.size();
+    operators.resize(num_operators);
+    precondition_of.resize(num_facts);
+    operators_ignoring_variable.resize(num_variables);
+    operator_mentions_variable.assign(
+        static_cast<size_t>(num_operators) * num_variables, false);
+    for (OperatorProxy op : task_operators) {
+        int op_id = op.get_id();
+        size_t mentions_offset = static_cast<size_t>(op_id) * num_variables;
+        HMOperator &hm_op = operators[op_id];
+        hm_op.cost = op.get_cost();
+
+        /*
+          Effect conditions are ignored. If effects assign different
+          values to the same variable, no tuple contains both facts.
+        */
+        vector<int> effect;
+        for (EffectProxy eff : op.get_effects()) {
+            FactPair fact = eff.get_fact().get_pair();
+            effect.push_back(get_fact_id(fact));
+            operator_mentions_variable[mentions_offset + fact.var] = true;
         }
-    } while (was_updated);
-}
-
-
-void HMHeuristic::extend_tuple(const Tuple &t, const OperatorProxy &op) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        bool contradict = false;
-        for (const FactPair &fact : tuple) {
-            if (contradict_effect_of(op, fact.var, fact.value)) {
-                contradict = true;
-                break;
+        sort(effect.begin(), effect.end());
+        effect.erase(unique(effect.begin(), effect.end()), effect.end());
+
+        vector<int> effect_and_prevail = effect;
+        for (FactProxy pre : op.get_preconditions()) {
+            FactPair fact = pre.get_pair();
+            int fact_id = get_fact_id(fact);
+            hm_op.precondition.push_back(fact_id);
+            precondition_of[fact_id].push_back(op_id);
+            if (!operator_mentions_variable[mentions_offset + fact.var]) {
+                effect_and_prevail.push_back(fact_id);
             }
         }
-        if (!contradict && (tuple.size() > t.size()) && (check_tuple_in_tuple(t, tuple) == 0)) {
-            Tuple pre = get_operator_pre(op);
-
-            Tuple others;
-            for (const FactPair &fact : tuple) {
-                if (find(t.begin(), t.end(), fact) == t.end()) {
-                    others.push_back(fact);
-                    if (find(pre.begin(), pre.end(), fact) == pre.end()) {
-                        pre.push_back(fact);
+        for (FactProxy pre : op.get_preconditions()) {
+            operator_mentions_variable[mentions_offset + pre.get_variable().get_id()] = true;
+        }
+        sort(hm_op.precondition.begin(), hm_op.precondition.end());
+        sort(effect_and_prevail.begin(), effect_and_prevail.end());
+
+        vector<int> subset;
+        for_each_subset(
+            effect_and_prevail, m, subset, 0,
+            [&](const vector<int> &tuple) {
+                bool has_effect_fact = false;
+                for (size_t i = 0; i < tuple.size(); ++i) {
+                    if (i > 0 &&
+                        fact_to_variable[tuple[i - 1]] == fact_to_variable[tuple[i]]) {
+                        return;
+                    }
+                    if (binary_search(effect.begin(), effect.end(), tuple[i])) {
+                        has_effect_fact = true;
                     }
                 }
-            }
-
-            sort(pre.begin(), pre.end());
-
-            set<int> vars;
-            bool is_valid = true;
-            for (const FactPair &fact : pre) {
-                if (vars.count(fact.var) != 0) {
-                    is_valid = false;
-                    break;
+                if (has_effect_fact) {
+                    hm_op.effect_tuples.push_back(tuple);
                 }
-                vars.insert(fact.var);
+            });
+        stable_sort(hm_op.effect_tuples.begin(), hm_op.effect_tuples.end(),
+                    [](const vector<int> &tuple1, const vector<int> &tuple2) {
+                        return tuple1.size() < tuple2.size();
+                    });
+        for (const vector<int> &tuple : hm_op.effect_tuples) {
+            hm_op.effect_tuple_ids.push_back(get_tuple_id(tuple));
+        }
+
+        /*
+          The meta-action for a context C needs the tuples that consist
+          of C and at most m - |C| precondition facts, and for |C| >= 2,
+          the |C| meta-actions for the contexts with one fact less. For
+          |C| = 1, the meta-action for the empty context is handled
+          separately (see handle_satisfied_context).
+        */
+        int num_preconditions = hm_op.precondition.size();
+        for (int context_size = 0; context_size < m; ++context_size) {
+            int num_conditions = 0;
+            for (int k = 0; k <= m - context_size; ++k) {
+                num_conditions += binomials[k][num_preconditions];
             }
+            if (context_size >= 2) {
+                num_conditions += context_size;
+            }
+            hm_op.num_conditions_by_context_size.push_back(num_conditions);
+        }
 
-            if (is_valid) {
-                int c2 = eval(pre);
-                if (c2 != numeric_limits<int>::max()) {
-                    update_hm_entry(tuple, c2 + op.get_cost());
-                }
+        for (int var = 0; var < num_variables; ++var) {
+            if (!operator_mentions_variable[mentions_offset + var]) {
+                operators_ignoring_variable[var].push_back(op_id);
             }
         }
     }
 }
 
-
-int HMHeuristic::eval(const Tuple &t) const {
-    vector<Tuple> partial;
-    generate_all_partial_tuples(t, partial);
-    int max = 0;
-    for (Tuple &tuple : partial) {
-        assert(hm_table.count(tuple) == 1);
-
-        int h = hm_table.at(tuple);
-        if (h > max) {
-            max = h;
-        }
+void HMHeuristic::build_goal_tuples() {
+    vector<int> goal_facts;
+    for (FactProxy goal : task_proxy.get_goals()) {
+        goal_facts.push_back(get_fact_id(goal.get_pair()));
     }
-    return max;
+    sort(goal_facts.begin(), goal_facts.end());
+    is_goal_tuple.assign(tuple_offsets[m + 1], false);
+    vector<int> subset;
+    for_each_subset(
+        goal_facts, m, subset, 0,
+        [&](const vector<int> &tuple) {
+            if (!tuple.empty()) {
+                is_goal_tuple[get_tuple_id(tuple)] = true;
+                ++num_goal_tuples;
+            }
+        });
 }
 
-
-int HMHeuristic::update_hm_entry(const Tuple &t, int val) {
-    assert(hm_table.count(t) == 1);
-    if (hm_table[t] > val) {
-        hm_table[t] = val;
-        was_updated = true;
+int HMHeuristic::get_tuple_id(const vector<int> &facts) const {
+    assert(is_sorted(facts.begin(), facts.end()));
+    int id = tuple_offsets[facts.size()];
+    for (size_t i = 0; i < facts.size(); ++i) {
+        id += binomials[i + 1][facts[i]];
     }
-    return val;
+    return id;
 }
 
+void HMHeuristic::get_tuple_facts(int tuple_id, vector<int> &facts) const {
+    int size = upper_bound(tuple_offsets.begin(), tuple_offsets.end(), tuple_id) -
+        tuple_offsets.begin() - 1;
+    int rank = tuple_id - tuple_offsets[size];
+    facts.resize(size);
+    for (int k = size; k >= 1; --k) {
+        // The largest fact f with (f choose k) <= rank.
+        const vector<int> &values = binomials[k];
+        int fact = upper_bound(values.begin(), values.end(), rank) -
+            values.begin() - 1;
+        facts[k - 1] = fact;
+        rank -= values[fact];
+    }
+    assert(rank == 0);
+}
 
-int HMHeuristic::check_tuple_in_tuple(
-    const Tuple &tuple, const Tuple &big_tuple) const {
-    for (const FactPair &fact0 : tuple) {
-        bool found = false;
-        for (auto &fact1 : big_tuple) {
-            if (fact0 == fact1) {
-                found = true;
-                break;
-            }
-        }
-        if (!found) {
-            return numeric_limits<int>::max();
+bool HMHeuristic::ignores_facts(int op_id, const vector<int> &facts) const {
+    size_t mentions_offset = static_cast<size_t>(op_id) * num_variables;
+    for (int fact : facts) {
+        if (operator_mentions_variable[mentions_offset + fact_to_variable[fact]]) {
+            return false;
         }
     }
-    return 0;
+    return true;
 }
 
-
-HMHeuristic::Tuple HMHeuristic::get_operator_pre(const OperatorProxy &op) const {
-    Tuple preconditions = task_properties::get_fact_pairs(op.get_preconditions());
-    sort(preconditions.begin(), preconditions.end());
-    return preconditions;
+void HMHeuristic::enqueue_if_necessary(int tuple_id, int cost) {
+    assert(cost >= 0);
+    int &tuple_cost = tuple_costs[tuple_id];
+    if (tuple_cost == -1) {
+        reached_tuples.push_back(tuple_id);
+    }
+    if (tuple_cost == -1 || tuple_cost > cost) {
+        tuple_cost = cost;
+        queue.push(cost, tuple_id);
+    }
 }
 
-
-HMHeuristic::Tuple HMHeuristic::get_operator_eff(const OperatorProxy &op) const {
-    Tuple effects;
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(eff.get_fact().get_pair());
+void HMHeuristic::decrement_counter(
+    int op_id, const vector<int> &context, int cost) {
+    int context_id = get_tuple_id(context);
+    vector<int> &context_counters = counters[context_id];
+    if (!context_reached[context_id]) {
+        context_reached[context_id] = true;
+        reached_contexts.push_back(context_id);
+        if (context_counters.empty()) {
+            // First time any evaluation reaches this context.
+            context_counters.resize(operators.size(), 0);
+        }
+    }
+    int &counter = context_counters[op_id];
+    if (counter == 0) {
+        counter = operators[op_id].num_conditions_by_context_size[context.size()];
+    }
+    assert(counter > 0);
+    if (--counter == 0) {
+        counter = -1;
+        handle_satisfied_context(op_id, context, cost);
     }
-    sort(effects.begin(), effects.end());
-    return effects;
 }
 
+void HMHeuristic::handle_satisfied_context(
+    int op_id, const vector<int> &context, int cost) {
+    /*
+      Since tuples are processed in the order of their costs, cost is the
+      maximal cost of the satisfied conditions.
+    */
+    vector<int> &pending = pending_contexts[op_id];
+    if (context.empty()) {
+        apply_meta_action(op_id, context, cost);
+        vector<int> pending_context;
+        for (size_t i = 0; i < pending.size(); i += pending[i] + 1) {
+            pending_context.assign(pending.begin() + i + 1,
+                                   pending.begin() + i + 1 + pending[i]);
+            apply_meta_action(op_id, pending_context, cost);
+        }
+        pending.clear();
+        return;
+    }
+
+    if (counters[0][op_id] == -1) {
+        apply_meta_action(op_id, context, cost);
+    } else {
+        pending.push_back(context.size());
+        pending.insert(pending.end(), context.begin(), context.end());
+    }
 
-bool HMHeuristic::contradict_effect_of(
-    const OperatorProxy &op, int var, int val) const {
-    for (EffectProxy eff : op.get_effects()) {
-        FactProxy fact = eff.get_fact();
-        if (fact.get_variable().get_id() == var && fact.get_value() != val) {
-            return true;
+    if (static_cast<int>(context.size()) < m - 1) {
+        size_t mentions_offset = static_cast<size_t>(op_id) * num_variables;
+        vector<int> extended_context;
+        for (int var = 0; var < num_variables; ++var) {
+            if (operator_mentions_variable[mentions_offset + var] ||
+                any_of(context.begin(), context.end(),
+                       [&](int fact) {return fact_to_variable[fact] == var;})) {
+                continue;
+            }
+            for (int fact = variable_offsets[var];
+                 fact < variable_offsets[var + 1]; ++fact) {
+                extended_context = context;
+                extended_context.insert(
+                    upper_bound(extended_context.begin(),
+                                extended_context.end(), fact),
+                    fact);
+                decrement_counter(op_id, extended_context, cost);
+            }
         }
     }
-    return false;
 }
 
-
-void HMHeuristic::generate_all_tuples() {
-    Tuple t;
-    generate_all_tuples_aux(0, m, t);
+void HMHeuristic::apply_meta_action(
+    int op_id, const vector<int> &context, int cost) {
+    const HMOperator &op = operators[op_id];
+    int successor_cost = cost + op.cost;
+    if (context.empty()) {
+        for (int tuple_id : op.effect_tuple_ids) {
+            enqueue_if_necessary(tuple_id, successor_cost);
+        }
+        return;
+    }
+    for (const vector<int> &effect_tuple : op.effect_tuples) {
+        if (static_cast<int>(effect_tuple.size() + context.size()) > m) {
+            break;
+        }
+        tuple_buffer.clear();
+        merge(context.begin(), context.end(),
+              effect_tuple.begin(), effect_tuple.end(),
+              back_inserter(tuple_buffer));
+        enqueue_if_necessary(get_tuple_id(tuple_buffer), successor_cost);
+    }
 }
 
+void HMHeuristic::process_tuple(int cost) {
+    /*
+      The tuple is a precondition of the meta-actions for the operators o
+      and contexts C with C <= tuple, tuple - C <= pre(o) and |C| < m.
+    */
+    const vector<int> &tuple = popped_tuple;
+    int size = tuple.size();
+    for (int mask = 0; mask < (1 << size); ++mask) {
+        context_buffer.clear();
+        rest_buffer.clear();
+        for (int i = 0; i < size; ++i) {
+            if (mask & (1 << i)) {
+                context_buffer.push_back(tuple[i]);
+            } else {
+                rest_buffer.push_back(tuple[i]);
+            }
+        }
+        if (static_cast<int>(context_buffer.size()) >= m) {
+            continue;
+        }
 
-void HMHeuristic::generate_all_tuples_aux(int var, int sz, const Tuple &base) {
-    int num_variables = task_proxy.get_variables().size();
-    for (int i = var; i < num_variables; ++i) {
-        int domain_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain_size; ++j) {
-            Tuple tuple(base);
-            tuple.emplace_back(i, j);
-            hm_table[tuple] = 0;
-            if (sz > 1) {
-                generate_all_tuples_aux(i + 1, sz - 1, tuple);
+        if (!rest_buffer.empty()) {
+            for (int op_id : precondition_of[rest_buffer[0]]) {
+                const vector<int> &pre = operators[op_id].precondition;
+                if (includes(pre.begin(), pre.end(),
+                             rest_buffer.begin(), rest_buffer.end()) &&
+                    ignores_facts(op_id, context_buffer)) {
+                    decrement_counter(op_id, context_buffer, cost);
+                }
+            }
+        } else if (!context_buffer.empty()) {
+            int var = fact_to_variable[context_buffer[0]];
+            for (int op_id : operators_ignoring_variable[var]) {
+                if (ignores_facts(op_id, context_buffer)) {
+                    decrement_counter(op_id, context_buffer, cost);
+                }
+            }
+        } else {
+            // The empty tuple is a precondition of all operators.
+            for (size_t op_id = 0; op_id < operators.size(); ++op_id) {
+                decrement_counter(op_id, context_buffer, cost);
             }
         }
     }
 }
 
-
-void HMHeuristic::generate_all_partial_tuples(
-    const Tuple &base_tuple, vector<Tuple> &res) const {
-    Tuple t;
-    generate_all_partial_tuples_aux(base_tuple, t, 0, m, res);
+void HMHeuristic::clear_exploration_data() {
+    queue.clear();
+    for (int tuple_id : reached_tuples) {
+        tuple_costs[tuple_id] = -1;
+    }
+    reached_tuples.clear();
+    for (int context_id : reached_contexts) {
+        fill(counters[context_id].begin(), counters[context_id].end(), 0);
+        context_reached[context_id] = false;
+    }
+    reached_contexts.clear();
+    for (vector<int> &pending : pending_contexts) {
+        pending.clear();
+    }
 }
 
+bool HMHeuristic::dead_ends_are_reliable() const {
+    return !task_properties::has_axioms(task_proxy) && !has_cond_effects;
+}
 
-void HMHeuristic::generate_all_partial_tuples_aux(
-    const Tuple &base_tuple, const Tuple &t, int index, int sz, vector<Tuple> &res) const {
-    if (sz == 1) {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
+int HMHeuristic::compute_heuristic(const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    vector<int> state_facts;
+    state_facts.reserve(num_variables);
+    for (FactProxy fact : state) {
+        state_facts.push_back(get_fact_id(fact.get_pair()));
+    }
+    vector<int> subset;
+    for_each_subset(
+        state_facts, m, subset, 0,
+        [&](const vector<int> &tuple) {
+            enqueue_if_necessary(get_tuple_id(tuple), 0);
+        });
+
+    /*
+      The h^m value of the goal is the maximal cost of its tuples, which
+      is the cost of the last goal tuple that is processed.
+    */
+    int h = (num_goal_tuples == 0) ? 0 : DEAD_END;
+    int num_unreached_goal_tuples = num_goal_tuples;
+    while (h == DEAD_END && !queue.empty()) {
+        pair<int, int> top_pair = queue.pop();
+        int cost = top_pair.first;
+        int tuple_id = top_pair.second;
+        assert(tuple_costs[tuple_id] <= cost);
+        if (tuple_costs[tuple_id] < cost) {
+            continue;
         }
-    } else {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-            generate_all_partial_tuples_aux(base_tuple, tuple, i + 1, sz - 1, res);
+        if (is_goal_tuple[tuple_id] && --num_unreached_goal_tuples == 0) {
+            h = cost;
+        } else {
+            get_tuple_facts(tuple_id, popped_tuple);
+            process_tuple(cost);
         }
     }
+    clear_exploration_data();
+    return h;
 }
 
-
-void HMHeuristic::dump_table() const {
-    for (auto &hm_ent : hm_table) {
-        utils::g_log << "h(" << hm_ent.first << ") = " << hm_ent.second << endl;
-    }
-}
-
-
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
-    parser.document_synopsis("h^m heuristic", "");
+    parser.document_synopsis(
+        "h^m heuristic",
+        "The critical path heuristics of Haslum and Geffner (AIPS 2000), "
+        "computed as h^max of the Pi^m compilation (Haslum, ICAPS 2009). "
+        "This needs memory for (number of facts)^m tuples and "
+        "(number of operators) counters for each reached set of at most "
+        "m-1 facts, so m > 3 is only feasible for small tasks.");
     parser.document_language_support("action costs", "supported");
     parser.document_language_support("conditional effects", "ignored");
     parser.document_language_support("axioms", "ignored");
@@ -3,10 +3,8 @@
 
 #include "../heuristic.h"
 
-#include <algorithm>
-#include <iostream>
-#include <map>
-#include <string>
+#include "../algorithms/priority_queues.h"
+
 #include <vector>
 
 namespace options {
@@ -17,45 +15,114 @@ namespace hm_heuristic {
 /*
   Haslum's h^m heuristic family ("critical path heuristics").
 
-  This is a very slow implementation and should not be used for
-  speed benchmarks.
+  We compute h^m as h^max of the Pi^m compilation of the task (Haslum,
+  ICAPS 2009) with a generalized Dijkstra search, without building the
+  compilation explicitly. The atoms of Pi^m ("tuples") are the sets of at
+  most m facts on different variables. For each operator o and each set C
+  of at most m - 1 facts on variables that o does not mention ("context"),
+  Pi^m has a meta-action with precondition pre(o) + C that adds the tuples
+  of eff(o) + prevail(o) + C that contain C and at least one effect fact.
+  (Smaller contexts add the other tuples more cheaply.) Each meta-action
+  has a counter for its unreached precondition tuples that contain C.
+  The remaining precondition tuples are those of the meta-actions for the
+  contexts with one fact less, so these count as one condition each.
+
+  Facts are numbered consecutively and tuples and contexts are numbered
+  densely with the combinatorial number system, so the tuple table has an
+  entry for every set of at most m facts. Thus memory grows with the
+  number of facts to the power of m, and m = 2 or m = 3 are the practical
+  choices. Counters are only allocated for the contexts that are reached.
 */
-
 class HMHeuristic : public Heuristic {
-    using Tuple = std::vector<FactPair>;
-    // parameters
+    struct HMOperator {
+        int cost;
+        // Sorted fact IDs.
+        std::vector<int> precondition;
+        /*
+          Subsets of at most m facts of the effect and prevail facts that
+          contain an effect fact, ordered by size, and their tuple IDs.
+        */
+        std::vector<std::vector<int>> effect_tuples;
+        std::vector<int> effect_tuple_ids;
+        /*
+          Number of decrements after which the counter for a context of
+          the given size reaches 0.
+        */
+        std::vector<int> num_conditions_by_context_size;
+    };
+
     const int m;
     const bool has_cond_effects;
 
-    const Tuple goals;
-
-    // h^m table
-    std::map<Tuple, int> hm_table;
-    bool was_updated;
-
-    // auxiliary methods
-    void init_hm_table(const Tuple &t);
-    void update_hm_table();
-    int eval(const Tuple &t) const;
-    int update_hm_entry(const Tuple &t, int val);
-    void extend_tuple(const Tuple &t, const OperatorProxy &op);
-
-    int check_tuple_in_tuple(const Tuple &tuple, const Tuple &big_tuple) const;
-
-    int get_operator_pre_value(const OperatorProxy &op, int var) const;
-    Tuple get_operator_pre(const OperatorProxy &op) const;
-    Tuple get_operator_eff(const OperatorProxy &op) const;
-    bool contradict_effect_of(const OperatorProxy &op, int var, int val) const;
-
-    void generate_all_tuples();
-    void generate_all_tuples_aux(int var, int sz, const Tuple &base);
-
-    void generate_all_partial_tuples(const Tuple &base_tuple,
-                                     std::vector<Tuple> &res) const;
-    void generate_all_partial_tuples_aux(const Tuple &base_tuple, const Tuple &t, int index,
-                                         int sz, std::vector<Tuple> &res) const;
-
-    void dump_table() const;
+    int num_variables;
+    int num_facts;
+    /*
+      The ID of a fact is variable_offsets[var] + value. The last entry
+      is num_facts.
+    */
+    std::vector<int> variable_offsets;
+    std::vector<int> fact_to_variable;
+    // binomials[k][n] is n choose k for k <= m and n <= num_facts.
+    std::vector<std::vector<int>> binomials;
+    // ID of the first tuple with k facts, for k <= m + 1.
+    std::vector<int> tuple_offsets;
+    // Number of contexts (and thus counters) per operator.
+    int num_contexts;
+
+    std::vector<HMOperator> operators;
+    std::vector<std::vector<int>> precondition_of;
+    std::vector<std::vector<int>> operators_ignoring_variable;
+    // Entry op_id * num_variables + var.
+    std::vector<bool> operator_mentions_variable;
+    std::vector<bool> is_goal_tuple;
+    int num_goal_tuples;
+
+    // Data of the current evaluation, reset after each evaluation.
+    priority_queues::AdaptiveQueue<int> queue;
+    // The cost of each tuple, or -1 if the tuple has not been reached.
+    std::vector<int> tuple_costs;
+    std::vector<int> reached_tuples;
+    /*
+      The counter of the context with ID c for operator o is
+      counters[c][o]. It is 0 if the counter has not been initialized and
+      -1 once all conditions are satisfied. The counters of a context are
+      only allocated when an evaluation first reaches the context, so
+      contexts with unreachable facts need no memory.
+    */
+    std::vector<std::vector<int>> counters;
+    std::vector<bool> context_reached;
+    std::vector<int> reached_contexts;
+    /*
+      For each operator, the contexts whose conditions are satisfied
+      while the conditions of the empty context are not. Each context is
+      stored as its size followed by its facts.
+    */
+    std::vector<std::vector<int>> pending_contexts;
+    // Buffers that avoid allocations during the exploration.
+    std::vector<int> popped_tuple;
+    std::vector<int> context_buffer;
+    std::vector<int> rest_buffer;
+    std::vector<int> tuple_buffer;
+
+    void compute_binomials();
+    void build_operators();
+    void build_goal_tuples();
+
+    int get_fact_id(const FactPair &fact) const {
+        return variable_offsets[fact.var] + fact.value;
+    }
+    // The facts must be sorted.
+    int get_tuple_id(const std::vector<int> &facts) const;
+    void get_tuple_facts(int tuple_id, std::vector<int> &facts) const;
+    bool ignores_facts(int op_id, const std::vector<int> &facts) const;
+
+    void enqueue_if_necessary(int tuple_id, int cost);
+    void decrement_counter(int op_id, const std::vector<int> &context, int cost);
+    void handle_satisfied_context(
+        int op_id, const std::vector<int> &context, int cost);
+    void apply_meta_action(int op_id, const std::vector<int> &context, int cost);
+    void process_tuple(int cost);
+    void clear_exploration_data();
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
@@ -32,17 +32,12 @@ HSPMaxHeuristic::HSPMaxHeuristic(const Options &opts)
 // heuristic computation
 void HSPMaxHeuristic::setup_exploration_queue() {
     queue.clear();
-
-    for (Proposition &prop : propositions)
-        prop.cost = -1;
+    reset_exploration_data();
 
     // Deal with operators and axioms without preconditions.
-    for (UnaryOperator &op : unary_operators) {
-        op.unsatisfied_preconditions = op.num_preconditions;
-        op.cost = op.base_cost; // will be increased by precondition costs
-
-        if (op.unsatisfied_preconditions == 0)
-            enqueue_if_necessary(op.effect, op.base_cost);
+    for (OpID op_id : operators_without_preconditions) {
+        const UnaryOperator *op = get_operator(op_id);
+        enqueue_if_necessary(op->effect, op->base_cost);
     }
 }
 
@@ -69,13 +64,18 @@ void HSPMaxHeuristic::relaxed_exploration() {
             return;
         for (OpID op_id : precondition_of_pool.get_slice(
                  prop->precondition_of, prop->num_precondition_occurences)) {
-            UnaryOperator *unary_op = get_operator(op_id);
-            unary_op->cost = max(unary_op->cost,
-                                 unary_op->base_cost + prop_cost);
-            --unary_op->unsatisfied_preconditions;
-            assert(unary_op->unsatisfied_preconditions >= 0);
-            if (unary_op->unsatisfied_preconditions == 0)
-                enqueue_if_necessary(unary_op->effect, unary_op->cost);
+            UnaryOperatorStatus *status = get_operator_status(op_id);
+            --status->unsatisfied_preconditions;
+            assert(status->unsatisfied_preconditions >= 0);
+            if (status->unsatisfied_preconditions == 0) {
+                /*
+                  Propositions are popped in order of increasing cost, so
+                  the last precondition is the most expensive one. Until
+                  now, the cost is the base cost of the operator.
+                */
+                status->cost += prop_cost;
+                enqueue_if_necessary(status->effect, status->cost);
+            }
         }
     }
 }
@@ -88,6 +88,19 @@ RelaxationHeuristic::RelaxationHeuristic(const options::Options &opts)
             precondition_of_pool.append(precondition_of_vec);
         propositions[prop_id].num_precondition_occurences = precondition_of_vec.size();
     }
+
+    // Store the initial values of the per-exploration data.
+    initial_propositions = propositions;
+    initial_operator_statuses.reserve(num_unary_ops);
+    for (OpID op_id = 0; op_id < num_unary_ops; ++op_id) {
+        const UnaryOperator &op = unary_operators[op_id];
+        // The cost will be increased by precondition costs.
+        initial_operator_statuses.push_back(
+            {op.base_cost, op.num_preconditions, op.effect});
+        if (op.num_preconditions == 0)
+            operators_without_preconditions.push_back(op_id);
+    }
+    operator_statuses = initial_operator_statuses;
 }
 
 bool RelaxationHeuristic::dead_ends_are_reliable() const {
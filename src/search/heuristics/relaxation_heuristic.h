@@ -7,6 +7,7 @@
 
 #include "../utils/collections.h"
 
+#include <algorithm>
 #include <cassert>
 #include <vector>
 
@@ -42,9 +43,6 @@ struct UnaryOperator {
                   array_pool::ArrayPoolIndex preconditions,
                   PropID effect,
                   int operator_no, int base_cost);
-    int cost; // Used for h^max cost or h^add cost;
-              // includes operator cost (base_cost)
-    int unsatisfied_preconditions;
     PropID effect;
     int base_cost;
     int num_preconditions;
@@ -52,7 +50,24 @@ struct UnaryOperator {
     int operator_no; // -1 for axioms; index into the task's operators otherwise
 };
 
-static_assert(sizeof(UnaryOperator) == 28, "UnaryOperator has wrong size");
+static_assert(sizeof(UnaryOperator) == 20, "UnaryOperator has wrong size");
+
+/*
+  The data of a unary operator that the exploration needs. We keep it apart
+  from the UnaryOperator objects, so that the exploration loops only touch
+  12 bytes per operator and the data can be reset by copying an array. The
+  effect is duplicated here because most operators in typical tasks have a
+  single precondition and hence trigger when they are first visited.
+*/
+struct UnaryOperatorStatus {
+    int cost; // Used for h^max cost or h^add cost;
+              // includes operator cost (base_cost)
+    int unsatisfied_preconditions;
+    PropID effect;
+};
+
+static_assert(sizeof(UnaryOperatorStatus) == 12,
+              "UnaryOperatorStatus has wrong size");
 
 class RelaxationHeuristic : public Heuristic {
     void build_unary_operators(const OperatorProxy &op);
@@ -60,8 +75,15 @@ class RelaxationHeuristic : public Heuristic {
 
     // proposition_offsets[var_no]: first PropID related to variable var_no
     std::vector<PropID> proposition_offsets;
+
+    // Values of the propositions and operator statuses before an exploration.
+    std::vector<Proposition> initial_propositions;
+    std::vector<UnaryOperatorStatus> initial_operator_statuses;
 protected:
     std::vector<UnaryOperator> unary_operators;
+    // operator_statuses[op_id] belongs to unary_operators[op_id].
+    std::vector<UnaryOperatorStatus> operator_statuses;
+    std::vector<OpID> operators_without_preconditions;
     std::vector<Proposition> propositions;
     std::vector<PropID> goal_propositions;
 
@@ -106,6 +128,23 @@ protected:
         return &unary_operators[op_id];
     }
 
+    UnaryOperatorStatus *get_operator_status(OpID op_id) {
+        return &operator_statuses[op_id];
+    }
+
+    /*
+      Reset the propositions and operator statuses for a new exploration.
+      Both are copied from contiguous arrays, which the compiler turns into
+      vectorized copies.
+    */
+    void reset_exploration_data() {
+        std::copy(initial_propositions.begin(), initial_propositions.end(),
+                  propositions.begin());
+        std::copy(initial_operator_statuses.begin(),
+                  initial_operator_statuses.end(),
+                  operator_statuses.begin());
+    }
+
     const Proposition *get_proposition(int var, int value) const;
     Proposition *get_proposition(int var, int value);
     Proposition *get_proposition(const FactProxy &fact);
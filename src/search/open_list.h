@@ -91,6 +91,13 @@ public:
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) = 0;
 
+    /*
+      Add all evaluators that this open list uses directly into the result
+      set. Search engines use this to evaluate a batch of states with
+      Evaluator::compute_results before inserting them one by one.
+    */
+    virtual void get_evaluators(std::set<Evaluator *> &evals) = 0;
+
     /*
       Accessor method for only_preferred.
 
@@ -1,7 +1,10 @@
 #include "canonical_pdbs.h"
 
+#include "packed_hash_plan.h"
 #include "pattern_database.h"
 
+#include "../task_proxy.h"
+
 #include <algorithm>
 #include <cassert>
 #include <iostream>
@@ -16,29 +19,162 @@ CanonicalPDBs::CanonicalPDBs(
     : pdbs(pdbs), pattern_cliques(pattern_cliques) {
     assert(pdbs);
     assert(pattern_cliques);
+    compile_evaluation_plan();
 }
 
-int CanonicalPDBs::get_value(const State &state) const {
-    // If we have an empty collection, then pattern_cliques = { \emptyset }.
-    assert(!pattern_cliques->empty());
-    int max_h = 0;
-    vector<int> h_values;
-    h_values.reserve(pdbs->size());
-    state.unpack();
+void CanonicalPDBs::compile_evaluation_plan() {
+    hash_offsets.reserve(pdbs->size() + 1);
+    distance_tables.reserve(pdbs->size());
+    hash_offsets.push_back(0);
     for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
-        int h = pdb->get_value(state.get_unpacked_values());
-        if (h == numeric_limits<int>::max()) {
-            return numeric_limits<int>::max();
-        }
-        h_values.push_back(h);
+        const Pattern &pattern = pdb->get_pattern();
+        const vector<int> &multipliers = pdb->get_hash_multipliers();
+        hash_variables.insert(hash_variables.end(), pattern.begin(), pattern.end());
+        hash_multipliers.insert(
+            hash_multipliers.end(), multipliers.begin(), multipliers.end());
+        hash_offsets.push_back(hash_variables.size());
+        distance_tables.push_back(&pdb->get_distances());
     }
+
+    clique_offsets.reserve(pattern_cliques->size() + 1);
+    clique_offsets.push_back(0);
     for (const PatternClique &clique : *pattern_cliques) {
+        clique_pdb_indices.insert(
+            clique_pdb_indices.end(), clique.begin(), clique.end());
+        clique_offsets.push_back(clique_pdb_indices.size());
+    }
+
+    h_values.resize(pdbs->size());
+}
+
+int CanonicalPDBs::compute_max_clique_sum(const int *h) const {
+    int num_cliques = clique_offsets.size() - 1;
+    const int *pdb_indices = clique_pdb_indices.data();
+    int max_h = 0;
+    for (int clique_id = 0; clique_id < num_cliques; ++clique_id) {
         int clique_h = 0;
-        for (PatternID pdb_index : clique) {
-            clique_h += h_values[pdb_index];
+        for (int i = clique_offsets[clique_id]; i < clique_offsets[clique_id + 1]; ++i) {
+            clique_h += h[pdb_indices[i]];
         }
         max_h = max(max_h, clique_h);
     }
     return max_h;
 }
+
+template<typename HashIndex>
+int CanonicalPDBs::compute_value(const HashIndex &hash_index) const {
+    // If we have an empty collection, then pattern_cliques = { \emptyset }.
+    assert(!pattern_cliques->empty());
+    int num_pdbs = distance_tables.size();
+    for (int pdb_index = 0; pdb_index < num_pdbs; ++pdb_index) {
+        int h = (*distance_tables[pdb_index])[hash_index(0, pdb_index)];
+        if (h == numeric_limits<int>::max()) {
+            return numeric_limits<int>::max();
+        }
+        h_values[pdb_index] = h;
+    }
+    return compute_max_clique_sum(h_values.data());
+}
+
+template<typename HashIndex>
+void CanonicalPDBs::compute_values(
+    int num_states, const HashIndex &hash_index,
+    vector<int> &pdb_values, vector<int> &values) const {
+    assert(!pattern_cliques->empty());
+    assert(pdb_values.empty());
+    /*
+      We first compute the hash indices of all states in all PDBs, going
+      over the states so that each state is read once, and then replace
+      them by the distances one PDB after the other, so that each PDB is
+      only brought into the cache once per batch.
+    */
+    int num_pdbs = distance_tables.size();
+    pdb_values.resize(num_pdbs * num_states);
+    for (int i = 0; i < num_states; ++i) {
+        for (int pdb_index = 0; pdb_index < num_pdbs; ++pdb_index) {
+            pdb_values[pdb_index * num_states + i] = hash_index(i, pdb_index);
+        }
+    }
+    for (int pdb_index = 0; pdb_index < num_pdbs; ++pdb_index) {
+        distance_tables[pdb_index]->lookup(
+            pdb_values.data() + pdb_index * num_states, num_states);
+    }
+    for (int i = 0; i < num_states; ++i) {
+        bool is_dead_end = false;
+        for (int pdb_index = 0; pdb_index < num_pdbs; ++pdb_index) {
+            int h = pdb_values[pdb_index * num_states + i];
+            if (h == numeric_limits<int>::max()) {
+                is_dead_end = true;
+                break;
+            }
+            h_values[pdb_index] = h;
+        }
+        if (is_dead_end) {
+            values.push_back(numeric_limits<int>::max());
+        } else {
+            values.push_back(compute_max_clique_sum(h_values.data()));
+        }
+    }
+}
+
+int CanonicalPDBs::get_value(const State &state) const {
+    state.unpack();
+    const vector<int> &state_values = state.get_unpacked_values();
+    return compute_value(
+        [&](int, int pdb_index) {
+            int index = 0;
+            for (int i = hash_offsets[pdb_index]; i < hash_offsets[pdb_index + 1]; ++i) {
+                index += hash_multipliers[i] * state_values[hash_variables[i]];
+            }
+            return index;
+        });
+}
+
+void CanonicalPDBs::get_values(
+    const vector<State> &states, vector<int> &values) const {
+    pdb_values_buffer.clear();
+    get_values(states, pdb_values_buffer, values);
+}
+
+void CanonicalPDBs::get_values(
+    const vector<State> &states, vector<int> &pdb_values,
+    vector<int> &values) const {
+    for (const State &state : states) {
+        state.unpack();
+    }
+    compute_values(
+        states.size(),
+        [&](int state_index, int pdb_index) {
+            const vector<int> &state_values =
+                states[state_index].get_unpacked_values();
+            int index = 0;
+            for (int i = hash_offsets[pdb_index]; i < hash_offsets[pdb_index + 1]; ++i) {
+                index += hash_multipliers[i] * state_values[hash_variables[i]];
+            }
+            return index;
+        },
+        pdb_values, values);
+}
+
+int CanonicalPDBs::get_value(
+    const PackedHashPlan &plan, const State &state) const {
+    const PackedStateBin *buffer = state.get_buffer();
+    return compute_value(
+        [&](int, int pdb_index) {
+            return plan.get_hash_index(pdb_index, buffer);
+        });
+}
+
+void CanonicalPDBs::get_values(
+    const PackedHashPlan &plan, const vector<State> &states,
+    vector<int> &values) const {
+    pdb_values_buffer.clear();
+    compute_values(
+        states.size(),
+        [&](int state_index, int pdb_index) {
+            return plan.get_hash_index(
+                pdb_index, states[state_index].get_buffer());
+        },
+        pdb_values_buffer, values);
+}
 }
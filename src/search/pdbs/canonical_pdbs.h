@@ -4,14 +4,62 @@
 #include "types.h"
 
 #include <memory>
+#include <vector>
 
 class State;
 
 namespace pdbs {
+class DistanceTable;
+class PackedHashPlan;
+
+/*
+  The constructor compiles the PDBs and pattern cliques into a flat
+  evaluation plan: the pattern variables and hash multipliers of all PDBs
+  are stored in two arrays, and the cliques are stored as one array of
+  PDB indices with offsets (pdb_indices of clique i are in
+  clique_pdb_indices[clique_offsets[i], clique_offsets[i + 1])). Evaluating
+  a state then computes one hash index per PDB, looks up the dense vector
+  of PDB values and takes the maximum over the clique sums, without
+  following any pointers to the PDBs or the cliques.
+
+  get_value and get_values use scratch buffers, so they must not be
+  called on the same object from several threads at once.
+*/
 class CanonicalPDBs {
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
 
+    // Evaluation plan; see above.
+    std::vector<int> hash_offsets;
+    std::vector<int> hash_variables;
+    std::vector<int> hash_multipliers;
+    std::vector<const DistanceTable *> distance_tables;
+    std::vector<int> clique_offsets;
+    std::vector<int> clique_pdb_indices;
+
+    // Scratch buffers.
+    mutable std::vector<int> h_values;
+    mutable std::vector<int> pdb_values_buffer;
+
+    void compile_evaluation_plan();
+
+    /*
+      Return the maximum over the clique sums, where h[pdb_index] is the
+      value of the PDB with index pdb_index. All values must be finite.
+    */
+    int compute_max_clique_sum(const int *h) const;
+
+    /*
+      The following functions implement get_value and get_values for a
+      function hash_index(i, pdb_index) that returns the hash index of the
+      i-th state in the PDB with index pdb_index.
+    */
+    template<typename HashIndex>
+    int compute_value(const HashIndex &hash_index) const;
+    template<typename HashIndex>
+    void compute_values(
+        int num_states, const HashIndex &hash_index,
+        std::vector<int> &pdb_values, std::vector<int> &values) const;
 public:
     CanonicalPDBs(
         const std::shared_ptr<PDBCollection> &pdbs,
@@ -19,6 +67,37 @@ public:
     ~CanonicalPDBs() = default;
 
     int get_value(const State &state) const;
+    /*
+      Append the values of all given states to values. We look up the
+      states in one PDB after the other, so each PDB is only brought into
+      the cache once per batch.
+    */
+    void get_values(
+        const std::vector<State> &states, std::vector<int> &values) const;
+
+    /*
+      Like get_values, but also store the values of the individual PDBs
+      in pdb_values, which must be empty: pdb_values[pdb_index *
+      states.size() + i] is the value of the i-th state in the PDB with
+      index pdb_index.
+    */
+    void get_values(
+        const std::vector<State> &states, std::vector<int> &pdb_values,
+        std::vector<int> &values) const;
+
+    /*
+      Like get_value and get_values above, but the states must be
+      registered and are read directly from their packed data with the
+      given plan, which must be built for the PDBs of this object.
+    */
+    int get_value(const PackedHashPlan &plan, const State &state) const;
+    void get_values(
+        const PackedHashPlan &plan, const std::vector<State> &states,
+        std::vector<int> &values) const;
+
+    const PDBCollection &get_pdbs() const {
+        return *pdbs;
+    }
 };
 }
 
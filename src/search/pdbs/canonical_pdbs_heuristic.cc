@@ -8,6 +8,7 @@
 #include "../plugin.h"
 
 #include "../utils/logging.h"
+#include "../utils/memory.h"
 #include "../utils/timer.h"
 
 #include <iostream>
@@ -53,7 +54,8 @@ CanonicalPDBs get_canonical_pdbs_from_options(
             *pdbs,
             *pattern_cliques,
             num_variables,
-            max_time_dominance_pruning);
+            max_time_dominance_pruning,
+            opts.get<int>("threads_dominance_pruning"));
     }
 
     // Do not dump pattern collections for size reasons.
@@ -67,9 +69,26 @@ CanonicalPDBsHeuristic::CanonicalPDBsHeuristic(const Options &opts)
       canonical_pdbs(get_canonical_pdbs_from_options(task, opts)) {
 }
 
+const PackedHashPlan &CanonicalPDBsHeuristic::get_packed_hash_plan(
+    const int_packer::IntPacker &state_packer) {
+    if (!packed_hash_plan ||
+        &packed_hash_plan->get_state_packer() != &state_packer) {
+        packed_hash_plan = utils::make_unique_ptr<PackedHashPlan>(
+            canonical_pdbs.get_pdbs(), state_packer);
+    }
+    return *packed_hash_plan;
+}
+
 int CanonicalPDBsHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-    int h = canonical_pdbs.get_value(state);
+    const int_packer::IntPacker *state_packer = get_state_packer(ancestor_state);
+    int h;
+    if (state_packer) {
+        h = canonical_pdbs.get_value(
+            get_packed_hash_plan(*state_packer), ancestor_state);
+    } else {
+        State state = convert_ancestor_state(ancestor_state);
+        h = canonical_pdbs.get_value(state);
+    }
     if (h == numeric_limits<int>::max()) {
         return DEAD_END;
     } else {
@@ -77,6 +96,35 @@ int CanonicalPDBsHeuristic::compute_heuristic(const State &ancestor_state) {
     }
 }
 
+void CanonicalPDBsHeuristic::compute_results(vector<StateEvaluationContext> &batch) {
+    compute_batch_results(batch);
+}
+
+bool CanonicalPDBsHeuristic::supports_batch_evaluation() const {
+    return true;
+}
+
+void CanonicalPDBsHeuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &heuristics) {
+    size_t first = heuristics.size();
+    const int_packer::IntPacker *state_packer = get_state_packer(ancestor_states);
+    if (state_packer) {
+        canonical_pdbs.get_values(
+            get_packed_hash_plan(*state_packer), ancestor_states, heuristics);
+    } else {
+        vector<State> states;
+        states.reserve(ancestor_states.size());
+        for (const State &ancestor_state : ancestor_states) {
+            states.push_back(convert_ancestor_state(ancestor_state));
+        }
+        canonical_pdbs.get_values(states, heuristics);
+    }
+    for (size_t i = first; i < heuristics.size(); ++i) {
+        if (heuristics[i] == numeric_limits<int>::max())
+            heuristics[i] = DEAD_END;
+    }
+}
+
 void add_canonical_pdbs_options_to_parser(options::OptionParser &parser) {
     parser.add_option<double>(
         "max_time_dominance_pruning",
@@ -86,6 +134,12 @@ void add_canonical_pdbs_options_to_parser(options::OptionParser &parser) {
         "value because there are dominating subsets in the collection.",
         "infinity",
         Bounds("0.0", "infinity"));
+    parser.add_option<int>(
+        "threads_dominance_pruning",
+        "maximum number of threads for checking the pattern cliques for "
+        "dominance. The result does not depend on the number of threads.",
+        "1",
+        Bounds("1", "infinity"));
 }
 
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
@@ -2,6 +2,7 @@
 #define PDBS_CANONICAL_PDBS_HEURISTIC_H
 
 #include "canonical_pdbs.h"
+#include "packed_hash_plan.h"
 
 #include "../heuristic.h"
 
@@ -13,13 +14,25 @@ namespace pdbs {
 // Implements the canonical heuristic function.
 class CanonicalPDBsHeuristic : public Heuristic {
     CanonicalPDBs canonical_pdbs;
+    // Used for looking up registered states without unpacking them.
+    std::unique_ptr<PackedHashPlan> packed_hash_plan;
+
+    const PackedHashPlan &get_packed_hash_plan(
+        const int_packer::IntPacker &state_packer);
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states,
+        std::vector<int> &heuristics) override;
 
 public:
     explicit CanonicalPDBsHeuristic(const options::Options &opts);
     virtual ~CanonicalPDBsHeuristic() = default;
+
+    virtual void compute_results(
+        std::vector<StateEvaluationContext> &batch) override;
+    virtual bool supports_batch_evaluation() const override;
 };
 
 void add_canonical_pdbs_options_to_parser(options::OptionParser &parser);
@@ -8,18 +8,28 @@
 #include "../task_utils/task_properties.h"
 
 #include "../utils/countdown_timer.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 
+#include <algorithm>
 #include <limits>
 
 using namespace std;
 
 namespace pdbs {
+/*
+  Every thread that get_flaws starts executes at least this many plan
+  steps. Most refinement iterations only have to execute a few short
+  plans, and then starting threads costs more than it saves.
+*/
+static const int MIN_PLAN_STEPS_PER_THREAD = 1000;
+
 CEGAR::CEGAR(
     int max_pdb_size,
     int max_collection_size,
     bool use_wildcard_plans,
     double max_time,
+    int num_threads,
     utils::Verbosity verbosity,
     const shared_ptr<utils::RandomNumberGenerator> &rng,
     const shared_ptr<AbstractTask> &task,
@@ -29,6 +39,7 @@ CEGAR::CEGAR(
       max_collection_size(max_collection_size),
       use_wildcard_plans(use_wildcard_plans),
       max_time(max_time),
+      num_threads(num_threads),
       verbosity(verbosity),
       rng(rng),
       task(task),
@@ -73,6 +84,7 @@ CEGAR::CEGAR(
         }
         utils::g_log << endl;
         utils::g_log << "max time: " << max_time << endl;
+        utils::g_log << "threads: " << num_threads << endl;
         utils::g_log << "goal variables: ";
         for (const FactPair &goal : this->goals) {
             utils::g_log << goal.var << ", ";
@@ -248,10 +260,7 @@ FlawList CEGAR::apply_plan(int collection_index, vector<int> &current_state) con
 bool CEGAR::get_flaws_for_pattern(
     int collection_index, const State &concrete_init, FlawList &flaws) {
     PatternInfo &pattern_info = *pattern_collection[collection_index];
-    if (pattern_info.is_unsolvable()) {
-        utils::g_log << "task is unsolvable." << endl;
-        utils::exit_with(utils::ExitCode::SEARCH_UNSOLVABLE);
-    }
+    assert(!pattern_info.is_unsolvable());
 
     vector<int> current_state = concrete_init.get_unpacked_values();
     FlawList new_flaws = apply_plan(collection_index, current_state);
@@ -308,16 +317,50 @@ bool CEGAR::get_flaws_for_pattern(
 
 int CEGAR::get_flaws(const State &concrete_init, FlawList &flaws) {
     assert(flaws.empty());
+    vector<int> collection_indices;
+    int num_plan_steps = 0;
     for (size_t collection_index = 0;
          collection_index < pattern_collection.size(); ++collection_index) {
         if (pattern_collection[collection_index] &&
             !pattern_collection[collection_index]->is_solved()) {
-            bool solved =
-                get_flaws_for_pattern(collection_index, concrete_init, flaws);
-            if (solved) {
-                return collection_index;
+            if (pattern_collection[collection_index]->is_unsolvable()) {
+                utils::g_log << "task is unsolvable." << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_UNSOLVABLE);
             }
+            collection_indices.push_back(collection_index);
+            num_plan_steps +=
+                pattern_collection[collection_index]->get_plan().size();
+        }
+    }
+
+    /*
+      The plans only read the collection and each pattern only marks
+      itself as solved, so we can execute them independently. Collecting
+      the flaws per pattern keeps their order (and thus the chosen flaw)
+      independent of the number of threads. Executing a plan logs its
+      steps with verbose output, so we use a single thread in that case.
+    */
+    int num_patterns = collection_indices.size();
+    vector<FlawList> flaws_by_pattern(num_patterns);
+    vector<char> solved_by_pattern(num_patterns, false);
+    int used_threads = 1;
+    if (verbosity < utils::Verbosity::VERBOSE) {
+        used_threads = max(
+            1, min(num_threads, num_plan_steps / MIN_PLAN_STEPS_PER_THREAD));
+    }
+    utils::parallel_for(
+        num_patterns, used_threads,
+        [&](int i) {
+            solved_by_pattern[i] = get_flaws_for_pattern(
+                collection_indices[i], concrete_init, flaws_by_pattern[i]);
+        });
+    for (int i = 0; i < num_patterns; ++i) {
+        if (solved_by_pattern[i]) {
+            return collection_indices[i];
         }
+        flaws.insert(flaws.end(),
+                     make_move_iterator(flaws_by_pattern[i].begin()),
+                     make_move_iterator(flaws_by_pattern[i].end()));
     }
     return -1;
 }
@@ -103,6 +103,8 @@ class CEGAR {
     const int max_collection_size;
     const bool use_wildcard_plans;
     const double max_time;
+    // Maximum number of threads for executing the plans of the patterns.
+    const int num_threads;
     const utils::Verbosity verbosity;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
     const std::shared_ptr<AbstractTask> &task;
@@ -170,6 +172,7 @@ public:
         int max_collection_size,
         bool use_wildcard_plans,
         double max_time,
+        int num_threads,
         utils::Verbosity verbosity,
         const std::shared_ptr<utils::RandomNumberGenerator> &rng,
         const std::shared_ptr<AbstractTask> &task,
@@ -0,0 +1,152 @@
+#include "distance_table.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace pdbs {
+/*
+  The escaped distances follow the entries, starting at the next multiple
+  of the alignment of EscapedDistance.
+*/
+static size_t get_escaped_distances_offset(int bytes_per_entry, int num_entries) {
+    const size_t alignment = alignof(DistanceTable::EscapedDistance);
+    size_t entries_size = static_cast<size_t>(num_entries) * bytes_per_entry;
+    return (entries_size + alignment - 1) / alignment * alignment;
+}
+
+template<typename Entry>
+static int get_num_escaped_distances(const vector<int> &distances) {
+    int num_escaped = 0;
+    for (int distance : distances) {
+        if (distance != numeric_limits<int>::max() &&
+            static_cast<uint64_t>(distance) >=
+            numeric_limits<Entry>::max() - 1u) {
+            ++num_escaped;
+        }
+    }
+    return num_escaped;
+}
+
+DistanceTable::DistanceTable()
+    : bytes_per_entry(1),
+      num_entries(0),
+      num_escaped(0),
+      entries(nullptr),
+      escaped_distances(nullptr) {
+}
+
+DistanceTable::DistanceTable(const vector<int> &distances)
+    : num_entries(distances.size()) {
+    int num_escaped8 = get_num_escaped_distances<uint8_t>(distances);
+    int num_escaped16 = get_num_escaped_distances<uint16_t>(distances);
+    size_t memory8 = compute_memory_in_bytes(1, num_entries, num_escaped8);
+    size_t memory16 = compute_memory_in_bytes(2, num_entries, num_escaped16);
+    size_t memory32 = compute_memory_in_bytes(4, num_entries, 0);
+    if (memory8 < memory16 && memory8 < memory32) {
+        bytes_per_entry = 1;
+        num_escaped = num_escaped8;
+    } else if (memory16 < memory32) {
+        bytes_per_entry = 2;
+        num_escaped = num_escaped16;
+    } else {
+        bytes_per_entry = 4;
+        num_escaped = 0;
+    }
+
+    char *buffer = new char[max(get_memory_in_bytes(), size_t(1))];
+    set_data(shared_ptr<const char>(buffer, default_delete<const char[]>()));
+    switch (bytes_per_entry) {
+    case 1:
+        store<uint8_t>(distances, buffer);
+        break;
+    case 2:
+        store<uint16_t>(distances, buffer);
+        break;
+    default:
+        store<uint32_t>(distances, buffer);
+        break;
+    }
+}
+
+DistanceTable::DistanceTable(
+    int bytes_per_entry, int num_entries, int num_escaped,
+    const shared_ptr<const char> &data)
+    : bytes_per_entry(bytes_per_entry),
+      num_entries(num_entries),
+      num_escaped(num_escaped) {
+    assert(bytes_per_entry == 1 || bytes_per_entry == 2 || bytes_per_entry == 4);
+    assert(bytes_per_entry != 4 || num_escaped == 0);
+    set_data(data);
+}
+
+void DistanceTable::set_data(const shared_ptr<const char> &data_) {
+    data = data_;
+    entries = data.get();
+    escaped_distances = reinterpret_cast<const EscapedDistance *>(
+        data.get() + get_escaped_distances_offset(bytes_per_entry, num_entries));
+}
+
+template<typename Entry>
+void DistanceTable::store(const vector<int> &distances, char *buffer) {
+    const Entry escape = get_escape_entry<Entry>();
+    Entry *entry = reinterpret_cast<Entry *>(buffer);
+    EscapedDistance *escaped = reinterpret_cast<EscapedDistance *>(
+        buffer + get_escaped_distances_offset(bytes_per_entry, num_entries));
+    for (int index = 0; index < num_entries; ++index) {
+        int distance = distances[index];
+        if (distance == numeric_limits<int>::max()) {
+            entry[index] = get_dead_end_entry<Entry>();
+        } else if (static_cast<uint64_t>(distance) < escape) {
+            entry[index] = static_cast<Entry>(distance);
+        } else {
+            entry[index] = escape;
+            // Indices increase, so the escaped distances stay sorted.
+            escaped->state_index = index;
+            escaped->distance = distance;
+            ++escaped;
+        }
+    }
+    assert(escaped == escaped_distances + num_escaped);
+}
+
+template<typename Entry>
+void DistanceTable::lookup(int *indices, int num_indices) const {
+    const Entry *entry = static_cast<const Entry *>(entries);
+    for (int i = 0; i < num_indices; ++i) {
+        indices[i] = decode(entry[indices[i]], indices[i]);
+    }
+}
+
+void DistanceTable::lookup(int *indices, int num_indices) const {
+    switch (bytes_per_entry) {
+    case 1:
+        lookup<uint8_t>(indices, num_indices);
+        break;
+    case 2:
+        lookup<uint16_t>(indices, num_indices);
+        break;
+    default:
+        lookup<uint32_t>(indices, num_indices);
+        break;
+    }
+}
+
+int DistanceTable::get_escaped_distance(int index) const {
+    const EscapedDistance *end = escaped_distances + num_escaped;
+    const EscapedDistance *it = lower_bound(
+        escaped_distances, end, index,
+        [](const EscapedDistance &escaped, int index) {
+            return escaped.state_index < index;
+        });
+    assert(it != end && it->state_index == index);
+    return it->distance;
+}
+
+size_t DistanceTable::compute_memory_in_bytes(
+    int bytes_per_entry, int num_entries, int num_escaped) {
+    return get_escaped_distances_offset(bytes_per_entry, num_entries) +
+           static_cast<size_t>(num_escaped) * sizeof(EscapedDistance);
+}
+}
@@ -0,0 +1,139 @@
+#ifndef PDBS_DISTANCE_TABLE_H
+#define PDBS_DISTANCE_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace pdbs {
+/*
+  Compact storage for the goal distances of all abstract states of a PDB.
+
+  Distances are stored with 8, 16 or 32 bits per abstract state. The
+  largest value of each width marks dead ends and the second-largest value
+  is an escape marker for finite distances that do not fit into the
+  width. The distances of escaped states are kept in a sorted list of
+  (state index, distance) pairs. The constructor picks the width that
+  needs the least memory, so a PDB whose distances mostly fit into 8 bits
+  uses one byte per abstract state even if a few distances are larger.
+  With 32 bits, all finite int distances fit, so nothing is escaped.
+
+  Dead ends are reported as numeric_limits<int>::max(), like before.
+
+  The entries and the escaped distances are stored in one contiguous
+  block of data, which may be owned by the table or shared with a
+  memory-mapped file (see PDBCache). Copies of a table share the block.
+*/
+class DistanceTable {
+public:
+    struct EscapedDistance {
+        int state_index;
+        int distance;
+    };
+
+private:
+    int bytes_per_entry;
+    int num_entries;
+    int num_escaped;
+    std::shared_ptr<const char> data;
+    // Both point into data.
+    const void *entries;
+    const EscapedDistance *escaped_distances;
+
+    void set_data(const std::shared_ptr<const char> &data);
+
+    template<typename Entry>
+    static Entry get_dead_end_entry() {
+        return std::numeric_limits<Entry>::max();
+    }
+
+    template<typename Entry>
+    static Entry get_escape_entry() {
+        return std::numeric_limits<Entry>::max() - 1;
+    }
+
+    template<typename Entry>
+    void store(const std::vector<int> &distances, char *buffer);
+
+    template<typename Entry>
+    void lookup(int *indices, int num_indices) const;
+
+    int get_escaped_distance(int index) const;
+
+    template<typename Entry>
+    int decode(Entry entry, int index) const {
+        if (entry < get_escape_entry<Entry>()) {
+            return entry;
+        } else if (entry == get_dead_end_entry<Entry>()) {
+            return std::numeric_limits<int>::max();
+        } else {
+            return get_escaped_distance(index);
+        }
+    }
+public:
+    // Create an empty table.
+    DistanceTable();
+
+    /*
+      Create the table from the given distances, where dead ends are
+      represented by numeric_limits<int>::max().
+    */
+    explicit DistanceTable(const std::vector<int> &distances);
+
+    /*
+      Create the table from a block of data that was written for a table
+      with the given layout (see get_data). The block must stay valid as
+      long as data is referenced.
+    */
+    DistanceTable(
+        int bytes_per_entry, int num_entries, int num_escaped,
+        const std::shared_ptr<const char> &data);
+
+    int operator[](int index) const {
+        switch (bytes_per_entry) {
+        case 1:
+            return decode(static_cast<const std::uint8_t *>(entries)[index], index);
+        case 2:
+            return decode(static_cast<const std::uint16_t *>(entries)[index], index);
+        default:
+            return decode(static_cast<const std::uint32_t *>(entries)[index], index);
+        }
+    }
+
+    /*
+      Replace each of the num_indices state indices starting at indices
+      by its distance. This is faster than calling operator[] for each
+      index because the width is only checked once.
+    */
+    void lookup(int *indices, int num_indices) const;
+
+    int size() const {
+        return num_entries;
+    }
+
+    int get_bytes_per_entry() const {
+        return bytes_per_entry;
+    }
+
+    int get_num_escaped() const {
+        return num_escaped;
+    }
+
+    // Return the block holding the entries and the escaped distances.
+    const char *get_data() const {
+        return data.get();
+    }
+
+    // Return the number of bytes used for the entries and escaped distances.
+    std::size_t get_memory_in_bytes() const {
+        return compute_memory_in_bytes(bytes_per_entry, num_entries, num_escaped);
+    }
+
+    static std::size_t compute_memory_in_bytes(
+        int bytes_per_entry, int num_entries, int num_escaped);
+};
+}
+
+#endif
@@ -2,107 +2,133 @@
 
 #include "pattern_database.h"
 
+#include "../algorithms/dynamic_bitset.h"
 #include "../utils/countdown_timer.h"
-#include "../utils/hash.h"
 #include "../utils/logging.h"
+#include "../utils/parallel.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <unordered_map>
+#include <cstdint>
 #include <vector>
 
 using namespace std;
+using dynamic_bitset::DynamicBitset;
 
 namespace pdbs {
 class Pruner {
     /*
-      Algorithm for pruning dominated patterns.
+      Algorithm for pruning dominated pattern cliques.
 
-      "patterns" is the vector of patterns used.
-      Each pattern is a vector of variable IDs.
+      Dominance (see dominance_pruning.h) is reflexive and transitive.
+      Going over the cliques in order and letting each clique that is
+      not pruned yet prune all other dominated cliques prunes exactly the
+      cliques c2 for which there is a clique c1 != c2 that dominates c2
+      such that c2 does not dominate c1 (c2 is strictly dominated) or
+      c1 < c2 (c2 is equivalent to an earlier clique, so the first of
+      several duplicates survives). We use this characterization to
+      decide each clique on its own, so cliques can be checked in
+      parallel and the result does not depend on the number of threads.
 
-      "pattern_cliques" is the vector of pattern cliques.
-
-      The algorithm works by setting a "current pattern collection"
-      against which other patterns and collections can be tested for
-      dominance efficiently.
-
-      "variable_to_pattern_id" encodes the relevant information about the
-      current clique. For every variable v, variable_to_pattern_id[v] is
-      the id of the pattern containing v in the current clique,
-      or -1 if the variable is not contained in the current
-      clique. (Note that patterns in a pattern clique must be
-      disjoint, which is verified by an assertion in debug mode.)
-
-      To test if a given pattern v_1, ..., v_k is dominated by the
-      current clique, we check that all entries variable_to_pattern_id[v_i]
-      are equal and different from -1.
-
-      "dominated_patterns" is a vector<bool> that can be used to
-      quickly test whether a given pattern is dominated by the current
-      clique. This is precomputed for every pattern whenever the
-      current clique is set.
+      A clique that dominates c2 contains a superset of the largest
+      pattern p of c2. We find these supersets among the patterns that
+      contain the variable of p that occurs in the fewest patterns, and
+      only test the cliques containing them. Patterns and the variable
+      sets of cliques are stored as bitsets, so most subset tests only
+      need a few word operations.
     */
+    using Bitset = DynamicBitset<uint64_t>;
 
     const PatternCollection &patterns;
     const vector<PatternClique> &pattern_cliques;
-    const int num_variables;
 
-    vector<int> variable_to_pattern_id;
-    vector<bool> dominated_patterns;
+    vector<Bitset> pattern_variables;
+    vector<Bitset> clique_variables;
+    vector<int> num_clique_variables;
+    vector<vector<PatternID>> variable_to_patterns;
+    // The IDs of the cliques containing each pattern.
+    vector<vector<int>> pattern_to_cliques;
 
-    void set_current_clique(int clique_id) {
-        /*
-          Set the current pattern collection to be used for
-          is_pattern_dominated() or is_collection_dominated(). Compute
-          dominated_patterns based on the current pattern collection.
-        */
-        variable_to_pattern_id.assign(num_variables, -1);
-        assert(variable_to_pattern_id == vector<int>(num_variables, -1));
-        for (PatternID pattern_id : pattern_cliques[clique_id]) {
-            for (int variable : patterns[pattern_id]) {
-                assert(variable_to_pattern_id[variable] == -1);
-                variable_to_pattern_id[variable] = pattern_id;
+    bool is_pattern_dominated(PatternID pattern_id, int clique_id) const {
+        const Bitset &variables = pattern_variables[pattern_id];
+        for (PatternID other_id : pattern_cliques[clique_id]) {
+            if (variables.is_subset_of(pattern_variables[other_id])) {
+                return true;
             }
         }
-
-        dominated_patterns.clear();
-        dominated_patterns.reserve(patterns.size());
-        for (size_t i = 0; i < patterns.size(); ++i) {
-            dominated_patterns.push_back(is_pattern_dominated(i));
-        }
+        return false;
     }
 
-    bool is_pattern_dominated(int pattern_id) const {
-        /*
-          Check if the pattern with the given pattern_id is dominated
-          by the current pattern clique.
-        */
-        const Pattern &pattern = patterns[pattern_id];
-        assert(!pattern.empty());
-        PatternID clique_pattern_id = variable_to_pattern_id[pattern[0]];
-        if (clique_pattern_id == -1) {
+    bool is_clique_dominated(int clique_id, int dominating_clique_id) const {
+        if (!clique_variables[clique_id].is_subset_of(
+                clique_variables[dominating_clique_id])) {
             return false;
         }
-        int pattern_size = pattern.size();
-        for (int i = 1; i < pattern_size; ++i) {
-            if (variable_to_pattern_id[pattern[i]] != clique_pattern_id) {
+        for (PatternID pattern_id : pattern_cliques[clique_id]) {
+            if (!is_pattern_dominated(pattern_id, dominating_clique_id)) {
                 return false;
             }
         }
         return true;
     }
 
-    bool is_clique_dominated(int clique_id) const {
+    // Test the condition described above for c1 = other_id, c2 = clique_id.
+    bool is_pruned_by(int clique_id, int other_id) const {
+        if (other_id == clique_id || !is_clique_dominated(clique_id, other_id)) {
+            return false;
+        }
         /*
-          Check if the collection with the given collection_id is
-          dominated by the current pattern collection.
+          A clique with more variables cannot be dominated by clique_id,
+          so we only test for equivalence if both cliques have the same
+          number of variables.
         */
-        for (PatternID pattern_id : pattern_cliques[clique_id]) {
-            if (!dominated_patterns[pattern_id]) {
-                return false;
+        return other_id < clique_id ||
+               num_clique_variables[other_id] > num_clique_variables[clique_id] ||
+               !is_clique_dominated(other_id, clique_id);
+    }
+
+    bool is_clique_pruned(int clique_id) const {
+        const PatternClique &clique = pattern_cliques[clique_id];
+        if (clique.empty()) {
+            // The empty clique is dominated by all cliques.
+            for (size_t other_id = 0; other_id < pattern_cliques.size(); ++other_id) {
+                if (is_pruned_by(clique_id, other_id)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        PatternID pattern_id = *max_element(
+            clique.begin(), clique.end(),
+            [&](PatternID pattern1, PatternID pattern2) {
+                return patterns[pattern1].size() < patterns[pattern2].size();
+            });
+        const Pattern &pattern = patterns[pattern_id];
+        assert(!pattern.empty());
+        int rarest_var = *min_element(
+            pattern.begin(), pattern.end(),
+            [&](int var1, int var2) {
+                return variable_to_patterns[var1].size() <
+                       variable_to_patterns[var2].size();
+            });
+        /*
+          The patterns of a clique are disjoint, so each clique contains
+          at most one of the supersets and is tested at most once.
+        */
+        for (PatternID superset_id : variable_to_patterns[rarest_var]) {
+            if (!pattern_variables[pattern_id].is_subset_of(
+                    pattern_variables[superset_id])) {
+                continue;
+            }
+            for (int other_id : pattern_to_cliques[superset_id]) {
+                if (is_pruned_by(clique_id, other_id)) {
+                    return true;
+                }
             }
         }
-        return true;
+        return false;
     }
 
 public:
@@ -112,38 +138,61 @@ public:
         int num_variables)
         : patterns(patterns),
           pattern_cliques(pattern_cliques),
-          num_variables(num_variables) {
-    }
+          variable_to_patterns(num_variables),
+          pattern_to_cliques(patterns.size()) {
+        pattern_variables.reserve(patterns.size());
+        for (size_t pattern_id = 0; pattern_id < patterns.size(); ++pattern_id) {
+            pattern_variables.emplace_back(num_variables);
+            for (int var : patterns[pattern_id]) {
+                pattern_variables.back().set(var);
+                variable_to_patterns[var].push_back(pattern_id);
+            }
+        }
 
-    vector<bool> get_pruned_cliques(const utils::CountdownTimer &timer) {
         int num_cliques = pattern_cliques.size();
-        vector<bool> pruned(num_cliques, false);
-        /*
-          Already pruned cliques are not used to prune other
-          cliques. This makes things faster and helps handle
-          duplicate cliques in the correct way: the first copy
-          will survive and prune all duplicates.
-        */
-        for (int c1 = 0; c1 < num_cliques; ++c1) {
-            if (!pruned[c1]) {
-                set_current_clique(c1);
-                for (int c2 = 0; c2 < num_cliques; ++c2) {
-                    if (c1 != c2 && !pruned[c2] && is_clique_dominated(c2))
-                        pruned[c2] = true;
+        clique_variables.reserve(num_cliques);
+        num_clique_variables.reserve(num_cliques);
+        for (int clique_id = 0; clique_id < num_cliques; ++clique_id) {
+            clique_variables.emplace_back(num_variables);
+            int num_variables_in_clique = 0;
+            for (PatternID pattern_id : pattern_cliques[clique_id]) {
+                pattern_to_cliques[pattern_id].push_back(clique_id);
+                for (int var : patterns[pattern_id]) {
+                    // Patterns in a clique are disjoint.
+                    assert(!clique_variables.back().test(var));
+                    clique_variables.back().set(var);
+                    ++num_variables_in_clique;
                 }
             }
-            if (timer.is_expired()) {
-                /*
-                  Since after each iteration, we determined if a given
-                  clique is pruned or not, we can just break the
-                  computation here if reaching the time limit and use all
-                  information we collected so far.
-                */
-                utils::g_log << "Time limit reached. Abort dominance pruning." << endl;
-                break;
-            }
+            num_clique_variables.push_back(num_variables_in_clique);
         }
+    }
 
+    /*
+      Return for each clique whether it is pruned. If the time limit is
+      reached, the cliques that have not been checked yet are kept. This
+      is safe because every pruned clique is dominated by a clique that
+      is kept (the first clique of a maximal equivalence class).
+      We use char instead of bool so that threads can write different
+      entries at the same time.
+    */
+    vector<char> get_pruned_cliques(
+        const utils::CountdownTimer &timer, int num_threads) {
+        int num_cliques = pattern_cliques.size();
+        vector<char> pruned(num_cliques, false);
+        atomic<bool> timed_out(false);
+        utils::parallel_for(
+            num_cliques, num_threads,
+            [&](int clique_id) {
+                if (timed_out || timer.is_expired()) {
+                    timed_out = true;
+                    return;
+                }
+                pruned[clique_id] = is_clique_pruned(clique_id);
+            });
+        if (timed_out) {
+            utils::g_log << "Time limit reached. Abort dominance pruning." << endl;
+        }
         return pruned;
     }
 };
@@ -153,17 +202,18 @@ void prune_dominated_cliques(
     PDBCollection &pdbs,
     vector<PatternClique> &pattern_cliques,
     int num_variables,
-    double max_time) {
+    double max_time,
+    int num_threads) {
     utils::g_log << "Running dominance pruning..." << endl;
     utils::CountdownTimer timer(max_time);
 
     int num_patterns = patterns.size();
     int num_cliques = pattern_cliques.size();
 
-    vector<bool> pruned = Pruner(
+    vector<char> pruned = Pruner(
         patterns,
         pattern_cliques,
-        num_variables).get_pruned_cliques(timer);
+        num_variables).get_pruned_cliques(timer, num_threads);
 
     vector<PatternClique> remaining_pattern_cliques;
     vector<bool> is_remaining_pattern(num_patterns, false);
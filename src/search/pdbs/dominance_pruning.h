@@ -8,13 +8,20 @@ namespace pdbs {
   Clique superset dominates clique subset iff for every pattern
   p_subset in subset there is a pattern p_superset in superset where
   p_superset is a superset of p_subset.
+
+  Remove all cliques that are dominated by another clique (of several
+  equivalent cliques, the first one is kept) and all patterns and PDBs
+  that only occur in removed cliques. The cliques are checked with up to
+  num_threads threads. If max_time is reached, the remaining cliques are
+  kept, so the pruning found so far is used.
 */
 extern void prune_dominated_cliques(
     PatternCollection &patterns,
     PDBCollection &pdbs,
     std::vector<PatternClique> &pattern_cliques,
     int num_variables,
-    double max_time);
+    double max_time,
+    int num_threads = 1);
 }
 
 #endif
@@ -2,6 +2,7 @@
 
 #include "canonical_pdbs.h"
 #include "pattern_database.h"
+#include "utils.h"
 
 #include <limits>
 
@@ -9,25 +10,22 @@ using namespace std;
 
 namespace pdbs {
 IncrementalCanonicalPDBs::IncrementalCanonicalPDBs(
-    const TaskProxy &task_proxy, const PatternCollection &intitial_patterns)
+    const TaskProxy &task_proxy, const PatternCollection &intitial_patterns,
+    int num_threads, const shared_ptr<PDBCache> &pdb_cache)
     : task_proxy(task_proxy),
       patterns(make_shared<PatternCollection>(intitial_patterns.begin(),
                                               intitial_patterns.end())),
-      pattern_databases(make_shared<PDBCollection>()),
+      pattern_databases(make_shared<PDBCollection>(
+                            compute_pdbs(task_proxy, *patterns, num_threads,
+                                         pdb_cache))),
       pattern_cliques(nullptr),
       size(0) {
-    pattern_databases->reserve(patterns->size());
-    for (const Pattern &pattern : *patterns)
-        add_pdb_for_pattern(pattern);
+    for (const shared_ptr<PatternDatabase> &pdb : *pattern_databases)
+        size += pdb->get_size();
     are_additive = compute_additive_vars(task_proxy);
     recompute_pattern_cliques();
 }
 
-void IncrementalCanonicalPDBs::add_pdb_for_pattern(const Pattern &pattern) {
-    pattern_databases->push_back(make_shared<PatternDatabase>(task_proxy, pattern));
-    size += pattern_databases->back()->get_size();
-}
-
 void IncrementalCanonicalPDBs::add_pdb(const shared_ptr<PatternDatabase> &pdb) {
     patterns->push_back(pdb->get_pattern());
     pattern_databases->push_back(pdb);
@@ -41,7 +39,7 @@ void IncrementalCanonicalPDBs::recompute_pattern_cliques() {
 }
 
 vector<PatternClique> IncrementalCanonicalPDBs::get_pattern_cliques(
-    const Pattern &new_pattern) {
+    const Pattern &new_pattern) const {
     return pdbs::compute_pattern_cliques_with_pattern(
         *patterns, *pattern_cliques, new_pattern, are_additive);
 }
@@ -51,6 +49,13 @@ int IncrementalCanonicalPDBs::get_value(const State &state) const {
     return canonical_pdbs.get_value(state);
 }
 
+void IncrementalCanonicalPDBs::get_values(
+    const vector<State> &states, vector<int> &pdb_values,
+    vector<int> &values) const {
+    CanonicalPDBs canonical_pdbs(pattern_databases, pattern_cliques);
+    canonical_pdbs.get_values(states, pdb_values, values);
+}
+
 bool IncrementalCanonicalPDBs::is_dead_end(const State &state) const {
     state.unpack();
     for (const shared_ptr<PatternDatabase> &pdb : *pattern_databases)
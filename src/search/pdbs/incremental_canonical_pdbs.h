@@ -23,13 +23,12 @@ class IncrementalCanonicalPDBs {
     // The sum of all abstract state sizes of all pdbs in the collection.
     int size;
 
-    // Adds a PDB for pattern but does not recompute pattern_cliques.
-    void add_pdb_for_pattern(const Pattern &pattern);
-
     void recompute_pattern_cliques();
 public:
     IncrementalCanonicalPDBs(const TaskProxy &task_proxy,
-                             const PatternCollection &intitial_patterns);
+                             const PatternCollection &intitial_patterns,
+                             int num_threads = 1,
+                             const std::shared_ptr<PDBCache> &pdb_cache = nullptr);
     virtual ~IncrementalCanonicalPDBs() = default;
 
     // Adds a new PDB to the collection and recomputes pattern_cliques.
@@ -37,10 +36,19 @@ public:
 
     /* Returns a list of pattern cliques that would be additive to the new
        pattern. Detailed documentation in max_additive_pdb_sets.h */
-    std::vector<PatternClique> get_pattern_cliques(const Pattern &new_pattern);
+    std::vector<PatternClique> get_pattern_cliques(const Pattern &new_pattern) const;
 
     int get_value(const State &state) const;
 
+    /*
+      Append the values of the canonical heuristic for all given states to
+      values and store the values of the individual PDBs in pdb_values (see
+      CanonicalPDBs::get_values).
+    */
+    void get_values(
+        const std::vector<State> &states, std::vector<int> &pdb_values,
+        std::vector<int> &values) const;
+
     /*
       The following method offers a quick dead-end check for the sampling
       procedure of iPDB-hillclimbing. This exists because we can much more
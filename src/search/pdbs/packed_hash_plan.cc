@@ -0,0 +1,26 @@
+#include "packed_hash_plan.h"
+
+#include "pattern_database.h"
+
+using namespace std;
+using int_packer::IntPacker;
+
+namespace pdbs {
+PackedHashPlan::PackedHashPlan(
+    const PDBCollection &pdbs, const IntPacker &state_packer)
+    : state_packer(state_packer) {
+    offsets.reserve(pdbs.size() + 1);
+    offsets.push_back(0);
+    for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+        const Pattern &pattern = pdb->get_pattern();
+        const vector<int> &multipliers = pdb->get_hash_multipliers();
+        for (size_t i = 0; i < pattern.size(); ++i) {
+            IntPacker::BinExtraction extraction =
+                state_packer.get_bin_extraction(pattern[i]);
+            terms.push_back({extraction.bin_index, extraction.read_mask,
+                             extraction.shift, multipliers[i]});
+        }
+        offsets.push_back(terms.size());
+    }
+}
+}
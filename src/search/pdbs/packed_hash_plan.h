@@ -0,0 +1,54 @@
+#ifndef PDBS_PACKED_HASH_PLAN_H
+#define PDBS_PACKED_HASH_PLAN_H
+
+#include "types.h"
+
+#include "../algorithms/int_packer.h"
+
+#include <vector>
+
+namespace pdbs {
+/*
+  Precompiled perfect hash functions of a collection of PDBs that read the
+  pattern variables directly from the packed data of registered states,
+  so that heuristics do not have to unpack states before looking them up.
+
+  Each pattern variable is compiled into one term
+  (buffer[bin_index] & read_mask) >> shift times its hash multiplier, and
+  the terms of all PDBs are stored in one array with offsets (the terms of
+  PDB i are in terms[offsets[i], offsets[i + 1])).
+*/
+class PackedHashPlan {
+    struct Term {
+        int bin_index;
+        int_packer::IntPacker::Bin read_mask;
+        int shift;
+        int multiplier;
+    };
+
+    const int_packer::IntPacker &state_packer;
+    std::vector<int> offsets;
+    std::vector<Term> terms;
+public:
+    PackedHashPlan(
+        const PDBCollection &pdbs, const int_packer::IntPacker &state_packer);
+
+    const int_packer::IntPacker &get_state_packer() const {
+        return state_packer;
+    }
+
+    int get_hash_index(
+        int pdb_index, const int_packer::IntPacker::Bin *buffer) const {
+        const Term *term = terms.data() + offsets[pdb_index];
+        const Term *end = terms.data() + offsets[pdb_index + 1];
+        int index = 0;
+        for (; term != end; ++term) {
+            index += term->multiplier * static_cast<int>(
+                (buffer[term->bin_index] & term->read_mask) >> term->shift);
+        }
+        return index;
+    }
+};
+}
+
+#endif
@@ -19,7 +19,8 @@ using namespace std;
 
 namespace pdbs {
 PatternCollectionGeneratorCombo::PatternCollectionGeneratorCombo(const Options &opts)
-    : max_states(opts.get<int>("max_states")) {
+    : PatternCollectionGenerator(opts),
+      max_states(opts.get<int>("max_states")) {
 }
 
 PatternCollectionInformation PatternCollectionGeneratorCombo::generate(
@@ -40,7 +41,8 @@ PatternCollectionInformation PatternCollectionGeneratorCombo::generate(
             patterns->emplace_back(1, goal_var_id);
     }
 
-    PatternCollectionInformation pci(task_proxy, patterns);
+    PatternCollectionInformation pci(
+        task_proxy, patterns, num_threads, pdb_cache);
     dump_pattern_collection_generation_statistics(
         "Combo generator", timer(), pci);
     return pci;
@@ -52,6 +54,7 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "maximum abstraction size for combo strategy",
         "1000000",
         Bounds("1", "infinity"));
+    add_generator_options_to_parser(parser);
 
     Options opts = parser.parse();
     if (parser.dry_run())
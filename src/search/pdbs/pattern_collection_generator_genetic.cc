@@ -12,6 +12,7 @@
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
@@ -27,7 +28,8 @@ using namespace std;
 namespace pdbs {
 PatternCollectionGeneratorGenetic::PatternCollectionGeneratorGenetic(
     const Options &opts)
-    : pdb_max_size(opts.get<int>("pdb_max_size")),
+    : PatternCollectionGenerator(opts),
+      pdb_max_size(opts.get<int>("pdb_max_size")),
       num_collections(opts.get<int>("num_collections")),
       num_episodes(opts.get<int>("num_episodes")),
       mutation_probability(opts.get<double>("mutation_probability")),
@@ -161,10 +163,13 @@ bool PatternCollectionGeneratorGenetic::mark_used_variables(
 
 void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values) {
     TaskProxy task_proxy(*task);
+    int num_pattern_collections = pattern_collections.size();
+    // Collections that respect the size limit (and disjointness), or nullptr.
+    vector<shared_ptr<PatternCollection>> valid_collections;
+    valid_collections.reserve(num_pattern_collections);
     for (const auto &collection : pattern_collections) {
         //utils::g_log << "evaluate pattern collection " << (i + 1) << " of "
         //     << pattern_collections.size() << endl;
-        double fitness = 0;
         bool pattern_valid = true;
         vector<bool> variables_used(task_proxy.get_variables().size(), false);
         shared_ptr<PatternCollection> pattern_collection = make_shared<PatternCollection>();
@@ -189,21 +194,31 @@ void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values)
             remove_irrelevant_variables(pattern);
             pattern_collection->push_back(pattern);
         }
-        if (!pattern_valid) {
-            /* Set fitness to a very small value to cover cases in which all
-               patterns are invalid. */
-            fitness = 0.001;
-        } else {
-            /* Generate the pattern collection heuristic and get its fitness
-               value. */
-            ZeroOnePDBs zero_one_pdbs(task_proxy, *pattern_collection);
-            fitness = zero_one_pdbs.compute_approx_mean_finite_h();
-            // Update the best heuristic found so far.
-            if (fitness > best_fitness) {
-                best_fitness = fitness;
-                utils::g_log << "best_fitness = " << best_fitness << endl;
-                best_patterns = pattern_collection;
+        valid_collections.push_back(pattern_valid ? pattern_collection : nullptr);
+    }
+
+    /* Set fitness to a very small value for invalid collections to cover
+       cases in which all patterns are invalid. */
+    vector<double> fitnesses(num_pattern_collections, 0.001);
+    /* Generate the pattern collection heuristics and get their fitness
+       values. The collections are independent, so we can build their
+       PDBs in parallel. */
+    utils::parallel_for(
+        num_pattern_collections, num_threads,
+        [&](int i) {
+            if (valid_collections[i]) {
+                ZeroOnePDBs zero_one_pdbs(task_proxy, *valid_collections[i]);
+                fitnesses[i] = zero_one_pdbs.compute_approx_mean_finite_h();
             }
+        });
+
+    for (int i = 0; i < num_pattern_collections; ++i) {
+        double fitness = fitnesses[i];
+        // Update the best heuristic found so far.
+        if (valid_collections[i] && fitness > best_fitness) {
+            best_fitness = fitness;
+            utils::g_log << "best_fitness = " << best_fitness << endl;
+            best_patterns = valid_collections[i];
         }
         fitness_values.push_back(fitness);
     }
@@ -282,7 +297,8 @@ PatternCollectionInformation PatternCollectionGeneratorGenetic::generate(
 
     TaskProxy task_proxy(*task);
     assert(best_patterns);
-    PatternCollectionInformation pci(task_proxy, best_patterns);
+    PatternCollectionInformation pci(
+        task_proxy, best_patterns, num_threads, pdb_cache);
     dump_pattern_collection_generation_statistics(
         "Genetic generator", timer(), pci);
     return pci;
@@ -372,6 +388,7 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "fitness) if its patterns are not disjoint",
         "false");
 
+    add_generator_options_to_parser(parser);
     utils::add_rng_options(parser);
 
     Options opts = parser.parse();
@@ -3,6 +3,7 @@
 #include "canonical_pdbs_heuristic.h"
 #include "incremental_canonical_pdbs.h"
 #include "pattern_database.h"
+#include "pdb_cache.h"
 #include "utils.h"
 #include "validation.h"
 
@@ -18,6 +19,7 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
@@ -113,7 +115,8 @@ static vector<vector<int>> compute_relevant_neighbours(const TaskProxy &task_pro
 
 
 PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(const Options &opts)
-    : pdb_max_size(opts.get<int>("pdb_max_size")),
+    : PatternCollectionGenerator(opts),
+      pdb_max_size(opts.get<int>("pdb_max_size")),
       collection_max_size(opts.get<int>("collection_max_size")),
       num_samples(opts.get<int>("num_samples")),
       min_improvement(opts.get<int>("min_improvement")),
@@ -123,15 +126,14 @@ PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(c
       hill_climbing_timer(0) {
 }
 
-int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
+void PatternCollectionGeneratorHillclimbing::generate_candidate_patterns(
     const TaskProxy &task_proxy,
     const vector<vector<int>> &relevant_neighbours,
     const PatternDatabase &pdb,
     set<Pattern> &generated_patterns,
-    PDBCollection &candidate_pdbs) {
+    PatternCollection &candidate_patterns) {
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
     for (int pattern_var : pattern) {
         assert(utils::in_bounds(pattern_var, relevant_neighbours));
         const vector<int> &connected_vars = relevant_neighbours[pattern_var];
@@ -153,21 +155,31 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                 sort(new_pattern.begin(), new_pattern.end());
                 if (!generated_patterns.count(new_pattern)) {
                     /*
-                      If we haven't seen this pattern before, generate a PDB
-                      for it and add it to candidate_pdbs if its size does not
-                      surpass the size limit.
+                      If we haven't seen this pattern before, add it to
+                      the candidate patterns (its PDB size does not
+                      surpass the size limit).
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        make_shared<PatternDatabase>(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    candidate_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+}
+
+int PatternCollectionGeneratorHillclimbing::compute_candidate_pdbs(
+    const TaskProxy &task_proxy,
+    const PatternCollection &candidate_patterns,
+    PDBCollection &candidate_pdbs) const {
+    PDBCollection new_pdbs =
+        compute_pdbs(task_proxy, candidate_patterns, num_threads, pdb_cache);
+    int max_pdb_size = 0;
+    for (shared_ptr<PatternDatabase> &pdb : new_pdbs) {
+        max_pdb_size = max(max_pdb_size, pdb->get_size());
+        candidate_pdbs.push_back(move(pdb));
+    }
     return max_pdb_size;
 }
 
@@ -193,6 +205,7 @@ void PatternCollectionGeneratorHillclimbing::sample_states(
 pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     const vector<State> &samples,
     const vector<int> &samples_h_values,
+    const vector<int> &samples_pdb_values,
     PDBCollection &candidate_pdbs) {
     /*
       TODO: The original implementation by Haslum et al. uses A* to compute
@@ -204,11 +217,7 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     int improvement = 0;
     int best_pdb_index = -1;
 
-    // Iterate over all candidates and search for the best improving pattern/pdb
     for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
         if (!pdb) {
             /* candidate pattern is too large or has already been added to
@@ -222,32 +231,32 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
         int combined_size = current_pdbs->get_size() + pdb->get_size();
         if (combined_size > collection_max_size) {
             candidate_pdbs[i] = nullptr;
-            continue;
         }
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        vector<PatternClique> pattern_cliques =
-            current_pdbs->get_pattern_cliques(pdb->get_pattern());
-        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
-            const State &sample = samples[sample_id];
-            assert(utils::in_bounds(sample_id, samples_h_values));
-            int h_collection = samples_h_values[sample_id];
-            if (is_heuristic_improved(
-                    *pdb, sample, h_collection,
-                    *current_pdbs->get_pattern_databases(), pattern_cliques)) {
-                ++count;
+    /*
+      Calculate the "counting approximation" for all candidates: count the
+      number of samples for which the current pattern collection heuristic
+      would be improved if the new pattern was included into it. Each
+      candidate only writes its own count, so the counts do not depend on
+      the number of threads.
+    */
+    vector<int> counts(candidate_pdbs.size(), 0);
+    utils::parallel_for(
+        candidate_pdbs.size(), num_threads,
+        [&](int i) {
+            if (candidate_pdbs[i]) {
+                counts[i] = count_improved_samples(
+                    *candidate_pdbs[i], samples, samples_h_values,
+                    samples_pdb_values);
             }
-        }
+        });
+
+    // Iterate over all candidates and search for the best improving pattern/pdb
+    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
+        int count = counts[i];
+        if (count == -1)
+            throw HillClimbingTimeout();
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -261,33 +270,58 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     return make_pair(improvement, best_pdb_index);
 }
 
-bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
-    const PatternDatabase &pdb, const State &sample, int h_collection,
-    const PDBCollection &pdbs, const vector<PatternClique> &pattern_cliques) {
-    const vector<int> &sample_data = sample.get_unpacked_values();
-    // h_pattern: h-value of the new pattern
-    int h_pattern = pdb.get_value(sample_data);
+int PatternCollectionGeneratorHillclimbing::count_improved_samples(
+    const PatternDatabase &pdb,
+    const vector<State> &samples,
+    const vector<int> &samples_h_values,
+    const vector<int> &samples_pdb_values) const {
+    // Exceptions must not leave the threads of parallel_for.
+    if (hill_climbing_timer->is_expired())
+        return -1;
 
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    vector<int> h_pattern_values;
+    h_pattern_values.reserve(samples.size());
+    pdb.get_values(samples, h_pattern_values);
+    vector<PatternClique> pattern_cliques =
+        current_pdbs->get_pattern_cliques(pdb.get_pattern());
+    int count = 0;
+    for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+        assert(utils::in_bounds(sample_id, samples_h_values));
+        if (is_heuristic_improved(
+                h_pattern_values[sample_id], samples_h_values[sample_id],
+                sample_id, samples_pdb_values, pattern_cliques)) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
+    int h_pattern, int h_collection, int sample_id,
+    const vector<int> &samples_pdb_values,
+    const vector<PatternClique> &pattern_cliques) const {
     if (h_pattern == numeric_limits<int>::max()) {
         return true;
     }
 
-    // h_collection: h-value of the current collection heuristic
+    /*
+      The collection heuristic is infinite iff one of its PDBs is, so all
+      PDB values are finite below.
+    */
     if (h_collection == numeric_limits<int>::max())
         return false;
 
-    vector<int> h_values;
-    h_values.reserve(pdbs.size());
-    for (const shared_ptr<PatternDatabase> &p : pdbs) {
-        int h = p->get_value(sample_data);
-        if (h == numeric_limits<int>::max())
-            return false;
-        h_values.push_back(h);
-    }
     for (const PatternClique &clilque : pattern_cliques) {
         int h_clique = 0;
         for (PatternID pattern_id : clilque) {
-            h_clique += h_values[pattern_id];
+            int h = samples_pdb_values[pattern_id * num_samples + sample_id];
+            assert(h != numeric_limits<int>::max());
+            h_clique += h;
         }
         if (h_pattern + h_clique > h_collection) {
             /*
@@ -315,15 +349,16 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     // The PDBs for the patterns in generated_patterns that satisfy the size
     // limit to avoid recomputation.
     PDBCollection candidate_pdbs;
-    // The maximum size over all PDBs in candidate_pdbs.
-    int max_pdb_size = 0;
+    PatternCollection candidate_patterns;
     for (const shared_ptr<PatternDatabase> &current_pdb :
          *(current_pdbs->get_pattern_databases())) {
-        int new_max_pdb_size = generate_candidate_pdbs(
+        generate_candidate_patterns(
             task_proxy, relevant_neighbours, *current_pdb, generated_patterns,
-            candidate_pdbs);
-        max_pdb_size = max(max_pdb_size, new_max_pdb_size);
+            candidate_patterns);
     }
+    // The maximum size over all PDBs in candidate_pdbs.
+    int max_pdb_size = compute_candidate_pdbs(
+        task_proxy, candidate_patterns, candidate_pdbs);
     /*
       NOTE: The initial set of candidate patterns (in generated_patterns) is
       guaranteed to be "normalized" in the sense that there are no duplicates
@@ -337,6 +372,7 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
     sampling::RandomWalkSampler sampler(task_proxy, *rng);
     vector<State> samples;
     vector<int> samples_h_values;
+    vector<int> samples_pdb_values;
 
     try {
         while (true) {
@@ -354,13 +390,14 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
 
             samples.clear();
             samples_h_values.clear();
+            samples_pdb_values.clear();
             sample_states(sampler, init_h, samples);
-            for (const State &sample : samples) {
-                samples_h_values.push_back(current_pdbs->get_value(sample));
-            }
+            // This also unpacks the samples for the lookups of the candidates.
+            current_pdbs->get_values(samples, samples_pdb_values, samples_h_values);
 
             pair<int, int> improvement_and_index =
-                find_best_improving_pdb(samples, samples_h_values, candidate_pdbs);
+                find_best_improving_pdb(
+                    samples, samples_h_values, samples_pdb_values, candidate_pdbs);
             int improvement = improvement_and_index.first;
             int best_pdb_index = improvement_and_index.second;
 
@@ -381,9 +418,12 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
             current_pdbs->add_pdb(best_pdb);
 
             // Generate candidate patterns and PDBs for next iteration.
-            int new_max_pdb_size = generate_candidate_pdbs(
+            candidate_patterns.clear();
+            generate_candidate_patterns(
                 task_proxy, relevant_neighbours, *best_pdb, generated_patterns,
-                candidate_pdbs);
+                candidate_patterns);
+            int new_max_pdb_size = compute_candidate_pdbs(
+                task_proxy, candidate_patterns, candidate_pdbs);
             max_pdb_size = max(max_pdb_size, new_max_pdb_size);
 
             // Remove the added PDB from candidate_pdbs.
@@ -421,7 +461,7 @@ PatternCollectionInformation PatternCollectionGeneratorHillclimbing::generate(
         initial_pattern_collection.emplace_back(1, goal_var_id);
     }
     current_pdbs = utils::make_unique_ptr<IncrementalCanonicalPDBs>(
-        task_proxy, initial_pattern_collection);
+        task_proxy, initial_pattern_collection, num_threads, pdb_cache);
     utils::g_log << "Done calculating initial pattern collection: " << timer << endl;
 
     State initial_state = task_proxy.get_initial_state();
@@ -432,6 +472,9 @@ PatternCollectionInformation PatternCollectionGeneratorHillclimbing::generate(
     PatternCollectionInformation pci = current_pdbs->get_pattern_collection_information();
     dump_pattern_collection_generation_statistics(
         "Hill climbing generator", timer(), pci);
+    if (pdb_cache) {
+        pdb_cache->dump_statistics();
+    }
     return pci;
 }
 
@@ -527,6 +570,7 @@ void add_hillclimbing_options(OptionParser &parser) {
         "spent for pruning dominated patterns.",
         "infinity",
         Bounds("0.0", "infinity"));
+    add_generator_options_to_parser(parser);
     utils::add_rng_options(parser);
 }
 
@@ -636,6 +680,8 @@ static shared_ptr<Heuristic> _parse_ipdb(OptionParser &parser) {
         "patterns", pgh);
     heuristic_opts.set<double>(
         "max_time_dominance_pruning", opts.get<double>("max_time_dominance_pruning"));
+    heuristic_opts.set<int>(
+        "threads_dominance_pruning", opts.get<int>("threads_dominance_pruning"));
 
     return make_shared<CanonicalPDBsHeuristic>(heuristic_opts);
 }
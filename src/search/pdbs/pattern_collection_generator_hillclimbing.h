@@ -52,16 +52,24 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       relevant variable are considered as candidate patterns. If the candidate
       pattern has not been previously considered (not contained in
       generated_patterns) and if building a PDB for it does not surpass the
-      size limit, then the PDB is built and added to candidate_pdbs.
-
-      The method returns the size of the largest PDB added to candidate_pdbs.
+      size limit, then it is added to candidate_patterns.
     */
-    int generate_candidate_pdbs(
+    void generate_candidate_patterns(
         const TaskProxy &task_proxy,
         const std::vector<std::vector<int>> &relevant_neighbours,
         const PatternDatabase &pdb,
         std::set<Pattern> &generated_patterns,
-        PDBCollection &candidate_pdbs);
+        PatternCollection &candidate_patterns);
+
+    /*
+      Build the PDBs for the given candidate patterns (in parallel if
+      num_threads > 1) and append them to candidate_pdbs in the order of
+      the patterns. Returns the size of the largest PDB built.
+    */
+    int compute_candidate_pdbs(
+        const TaskProxy &task_proxy,
+        const PatternCollection &candidate_patterns,
+        PDBCollection &candidate_pdbs) const;
 
     /*
       Performs num_samples random walks with a length (different for each
@@ -82,24 +90,43 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
       the index of the best pdb in candidate_pdbs.
+
+      samples_h_values contains the h-value of the current collection for
+      each sample and samples_pdb_values the values of the individual PDBs
+      of the current collection (see CanonicalPDBs::get_values). They are
+      computed once per iteration and shared by all candidates, which are
+      evaluated in parallel if num_threads > 1.
     */
     std::pair<int, int> find_best_improving_pdb(
         const std::vector<State> &samples,
         const std::vector<int> &samples_h_values,
+        const std::vector<int> &samples_pdb_values,
         PDBCollection &candidate_pdbs);
 
     /*
-      Returns true iff the h-value of the new pattern (from pdb) plus the
-      h-value of all pattern cliques from the current pattern
+      Count the samples for which the current collection heuristic would be
+      improved if the pattern of pdb was added to it (see
+      is_heuristic_improved). Returns -1 if the time limit is reached.
+    */
+    int count_improved_samples(
+        const PatternDatabase &pdb,
+        const std::vector<State> &samples,
+        const std::vector<int> &samples_h_values,
+        const std::vector<int> &samples_pdb_values) const;
+
+    /*
+      Returns true iff the h-value of the new pattern (h_pattern) plus the
+      h-value of one of the pattern cliques from the current pattern
       collection heuristic if the new pattern was added to it is greater than
-      the h-value of the current pattern collection.
+      the h-value of the current pattern collection (h_collection) for the
+      sample with the given ID.
     */
     bool is_heuristic_improved(
-        const PatternDatabase &pdb,
-        const State &sample,
+        int h_pattern,
         int h_collection,
-        const PDBCollection &pdbs,
-        const std::vector<PatternClique> &pattern_cliques);
+        int sample_id,
+        const std::vector<int> &samples_pdb_values,
+        const std::vector<PatternClique> &pattern_cliques) const;
 
     /*
       This is the core algorithm of this class. The initial PDB collection
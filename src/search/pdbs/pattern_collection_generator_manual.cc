@@ -14,14 +14,16 @@ using namespace std;
 
 namespace pdbs {
 PatternCollectionGeneratorManual::PatternCollectionGeneratorManual(const Options &opts)
-    : patterns(make_shared<PatternCollection>(opts.get_list<Pattern>("patterns"))) {
+    : PatternCollectionGenerator(opts),
+      patterns(make_shared<PatternCollection>(opts.get_list<Pattern>("patterns"))) {
 }
 
 PatternCollectionInformation PatternCollectionGeneratorManual::generate(
     const shared_ptr<AbstractTask> &task) {
     utils::g_log << "Manual pattern collection: " << *patterns << endl;
     TaskProxy task_proxy(*task);
-    return PatternCollectionInformation(task_proxy, patterns);
+    return PatternCollectionInformation(
+        task_proxy, patterns, num_threads, pdb_cache);
 }
 
 static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
@@ -29,6 +31,7 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "patterns",
         "list of patterns (which are lists of variable numbers of the planning "
         "task).");
+    add_generator_options_to_parser(parser);
 
     Options opts = parser.parse();
     if (parser.dry_run())
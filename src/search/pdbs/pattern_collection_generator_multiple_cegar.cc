@@ -9,9 +9,12 @@
 
 #include "../utils/countdown_timer.h"
 #include "../utils/markup.h"
+#include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 
+#include <limits>
 #include <vector>
 
 using namespace std;
@@ -19,7 +22,8 @@ using namespace std;
 namespace pdbs {
 PatternCollectionGeneratorMultipleCegar::PatternCollectionGeneratorMultipleCegar(
     options::Options &opts)
-    : max_pdb_size(opts.get<int>("max_pdb_size")),
+    : PatternCollectionGenerator(opts),
+      max_pdb_size(opts.get<int>("max_pdb_size")),
       max_collection_size(opts.get<int>("max_collection_size")),
       use_wildcard_plans(opts.get<bool>("use_wildcard_plans")),
       cegar_max_time(opts.get<double>("max_time")),
@@ -80,7 +84,8 @@ void PatternCollectionGeneratorMultipleCegar::handle_generated_pattern(
     PatternCollectionInformation &&collection_info,
     set<Pattern> &generated_patterns,
     shared_ptr<PDBCollection> &generated_pdbs,
-    const utils::CountdownTimer &timer) {
+    const utils::CountdownTimer &timer,
+    bool ignore_size_limit) {
     shared_ptr<PatternCollection> new_patterns = collection_info.get_patterns();
     if (new_patterns->size() > 1) {
         cerr << "a generator computed more than one pattern" << endl;
@@ -91,19 +96,29 @@ void PatternCollectionGeneratorMultipleCegar::handle_generated_pattern(
     if (verbosity >= utils::Verbosity::DEBUG) {
         utils::g_log << "generated patterns " << pattern << endl;
     }
-    if (generated_patterns.insert(pattern).second) {
+    shared_ptr<PDBCollection> new_pdbs = collection_info.get_pdbs();
+    shared_ptr<PatternDatabase> &pdb = new_pdbs->front();
+    if (generated_patterns.count(pattern)) {
+        // Pattern is not new. Set stagnation start time if not already set.
+        if (stagnation_start_time == -1) {
+            stagnation_start_time = timer.get_elapsed_time();
+        }
+    } else if (!ignore_size_limit && pdb->get_size() > remaining_collection_size) {
+        /*
+          The pattern was generated concurrently with the patterns handled
+          before it, which used up the size budget it was generated for.
+        */
+        if (verbosity >= utils::Verbosity::DEBUG) {
+            utils::g_log << "discarding pattern exceeding the remaining "
+                         << "collection size" << endl;
+        }
+    } else {
         // CEGAR generated a new pattern. Reset stagnation_start_time.
+        generated_patterns.insert(pattern);
         stagnation_start_time = -1;
 
-        shared_ptr<PDBCollection> new_pdbs = collection_info.get_pdbs();
-        shared_ptr<PatternDatabase> &pdb = new_pdbs->front();
         remaining_collection_size -= pdb->get_size();
         generated_pdbs->push_back(move(pdb));
-    } else {
-        // Pattern is not new. Set stagnation start time if not already set.
-        if (stagnation_start_time == -1) {
-            stagnation_start_time = timer.get_elapsed_time();
-        }
     }
 }
 
@@ -204,7 +219,7 @@ PatternCollectionInformation PatternCollectionGeneratorMultipleCegar::generate(
     set<Pattern> generated_patterns;
     shared_ptr<PDBCollection> generated_pdbs = make_shared<PDBCollection>();
 
-    int num_iterations = 1;
+    int num_iterations = 0;
     int goal_index = 0;
     const utils::Verbosity cegar_verbosity(utils::Verbosity::SILENT);
     shared_ptr<utils::RandomNumberGenerator> cegar_rng =
@@ -214,49 +229,78 @@ PatternCollectionInformation PatternCollectionGeneratorMultipleCegar::generate(
       blacklisting_trigger_percentage has passed. Compute this time point once.
     */
     double blacklisting_start_time = total_max_time * blacklist_trigger_percentage;
-    while (true) {
+    bool terminate = false;
+    while (!terminate) {
         check_blacklist_trigger_timer(blacklisting_start_time, timer);
 
-        unordered_set<int> blacklisted_variables =
-            get_blacklisted_variables(non_goal_variables);
-
+        /*
+          Start one CEGAR run per thread. All runs of a batch get the
+          remaining size budget and time limit, and the runs are set up
+          and their results handled in the same order as if they ran one
+          after the other. With a single thread, this is the sequential
+          algorithm.
+        */
         int remaining_pdb_size_for_cegar = min(remaining_collection_size, max_pdb_size);
         double remaining_time_for_cegar =
             min(static_cast<double>(timer.get_remaining_time()), cegar_max_time);
-        /*
-          Call CEGAR with the remaining size budget (limiting one of pdb and
-          collection size would be enough, but this is cleaner), with the
-          remaining time limit and an RNG instance with a different random
-          seed in each iteration.
-        */
-        CEGAR cegar(
-            remaining_pdb_size_for_cegar,
-            remaining_collection_size,
-            use_wildcard_plans,
-            remaining_time_for_cegar,
-            cegar_verbosity,
-            cegar_rng,
-            task,
-            {goals[goal_index]},
-            move(blacklisted_variables));
-        PatternCollectionInformation collection_info =
-            cegar.compute_pattern_collection();
-        handle_generated_pattern(
-            move(collection_info),
-            generated_patterns,
-            generated_pdbs,
-            timer);
-
-        if (collection_size_limit_reached() ||
-            time_limit_reached(timer) ||
-            check_for_stagnation(timer)) {
-            break;
+        vector<unique_ptr<CEGAR>> cegars;
+        for (int i = 0; i < num_threads; ++i) {
+            unordered_set<int> blacklisted_variables =
+                get_blacklisted_variables(non_goal_variables);
+            /*
+              Concurrent runs cannot share an RNG, so each of them gets
+              its own, seeded by the shared one.
+            */
+            shared_ptr<utils::RandomNumberGenerator> run_rng = cegar_rng;
+            if (num_threads > 1) {
+                run_rng = make_shared<utils::RandomNumberGenerator>(
+                    (*cegar_rng)(numeric_limits<int>::max()));
+            }
+            /*
+              Call CEGAR with the remaining size budget (limiting one of pdb
+              and collection size would be enough, but this is cleaner), with
+              the remaining time limit and an RNG instance with a different
+              random seed in each iteration.
+            */
+            cegars.push_back(utils::make_unique_ptr<CEGAR>(
+                                 remaining_pdb_size_for_cegar,
+                                 remaining_collection_size,
+                                 use_wildcard_plans,
+                                 remaining_time_for_cegar,
+                                 1,
+                                 cegar_verbosity,
+                                 run_rng,
+                                 task,
+                                 vector<FactPair> {goals[goal_index]},
+                                 move(blacklisted_variables)));
+            ++goal_index;
+            goal_index = goal_index % goals.size();
+            assert(utils::in_bounds(goal_index, goals));
         }
 
-        ++num_iterations;
-        ++goal_index;
-        goal_index = goal_index % goals.size();
-        assert(utils::in_bounds(goal_index, goals));
+        vector<unique_ptr<PatternCollectionInformation>> collection_infos(
+            cegars.size());
+        utils::parallel_for(
+            cegars.size(), num_threads,
+            [&](int i) {
+                collection_infos[i] =
+                    utils::make_unique_ptr<PatternCollectionInformation>(
+                        cegars[i]->compute_pattern_collection());
+            });
+
+        for (size_t i = 0; i < collection_infos.size() && !terminate; ++i) {
+            ++num_iterations;
+            handle_generated_pattern(
+                move(*collection_infos[i]),
+                generated_patterns,
+                generated_pdbs,
+                timer,
+                i == 0);
+
+            terminate = collection_size_limit_reached() ||
+                time_limit_reached(timer) ||
+                check_for_stagnation(timer);
+        }
     }
 
     PatternCollectionInformation result = get_pattern_collection(task_proxy, generated_pdbs);
@@ -319,6 +363,7 @@ static shared_ptr<PatternCollectionGenerator> _parse(options::OptionParser &pars
         "and terminate when stagnation_limit is hit for the second time.",
         "true");
     add_cegar_options_to_parser(parser);
+    add_generator_options_to_parser(parser);
     utils::add_verbosity_option_to_parser(parser);
     utils::add_rng_options(parser);
 
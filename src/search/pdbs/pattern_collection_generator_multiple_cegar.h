@@ -46,7 +46,8 @@ class PatternCollectionGeneratorMultipleCegar : public PatternCollectionGenerato
         PatternCollectionInformation &&collection_info,
         std::set<Pattern> &generated_patterns,
         std::shared_ptr<PDBCollection> &generated_pdbs,
-        const utils::CountdownTimer &timer);
+        const utils::CountdownTimer &timer,
+        bool ignore_size_limit);
     bool collection_size_limit_reached() const;
     bool time_limit_reached(const utils::CountdownTimer &timer) const;
     bool check_for_stagnation(const utils::CountdownTimer &timer);
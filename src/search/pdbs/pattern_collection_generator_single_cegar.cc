@@ -14,7 +14,8 @@ using namespace std;
 namespace pdbs {
 PatternCollectionGeneratorSingleCegar::PatternCollectionGeneratorSingleCegar(
     const options::Options &opts)
-    : max_pdb_size(opts.get<int>("max_pdb_size")),
+    : PatternCollectionGenerator(opts),
+      max_pdb_size(opts.get<int>("max_pdb_size")),
       max_collection_size(opts.get<int>("max_collection_size")),
       use_wildcard_plans(opts.get<bool>("use_wildcard_plans")),
       max_time(opts.get<double>("max_time")),
@@ -33,6 +34,7 @@ PatternCollectionInformation PatternCollectionGeneratorSingleCegar::generate(
         max_collection_size,
         use_wildcard_plans,
         max_time,
+        num_threads,
         verbosity,
         rng,
         task,
@@ -57,6 +59,7 @@ static shared_ptr<PatternCollectionGenerator> _parse(
             "2019"));
     add_implementation_notes_to_parser(parser);
     add_cegar_options_to_parser(parser);
+    add_generator_options_to_parser(parser);
     utils::add_verbosity_option_to_parser(parser);
     utils::add_rng_options(parser);
 
@@ -1,5 +1,7 @@
 #include "pattern_collection_generator_systematic.h"
 
+#include "distance_table.h"
+#include "pattern_database.h"
 #include "utils.h"
 #include "validation.h"
 
@@ -8,13 +10,18 @@
 #include "../task_proxy.h"
 
 #include "../task_utils/causal_graph.h"
+#include "../utils/collections.h"
+#include "../utils/countdown_timer.h"
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/math.h"
+#include "../utils/system.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <limits>
 
 using namespace std;
 
@@ -46,15 +53,8 @@ static void compute_union_pattern(
               back_inserter(result));
 }
 
-
-PatternCollectionGeneratorSystematic::PatternCollectionGeneratorSystematic(
-    const Options &opts)
-    : max_pattern_size(opts.get<int>("pattern_max_size")),
-      only_interesting_patterns(opts.get<bool>("only_interesting_patterns")) {
-}
-
-void PatternCollectionGeneratorSystematic::compute_eff_pre_neighbors(
-    const causal_graph::CausalGraph &cg, const Pattern &pattern, vector<int> &result) const {
+static void compute_eff_pre_neighbors(
+    const causal_graph::CausalGraph &cg, const Pattern &pattern, vector<int> &result) {
     /*
       Compute all variables that are reachable from pattern by an
       (eff, pre) arc and are not already contained in the pattern.
@@ -75,8 +75,8 @@ void PatternCollectionGeneratorSystematic::compute_eff_pre_neighbors(
     result.assign(candidates.begin(), candidates.end());
 }
 
-void PatternCollectionGeneratorSystematic::compute_connection_points(
-    const causal_graph::CausalGraph &cg, const Pattern &pattern, vector<int> &result) const {
+static void compute_connection_points(
+    const causal_graph::CausalGraph &cg, const Pattern &pattern, vector<int> &result) {
     /*
       The "connection points" of a pattern are those variables of which
       one must be contained in an SGA pattern that can be attached to this
@@ -115,6 +115,420 @@ void PatternCollectionGeneratorSystematic::compute_connection_points(
     result.assign(candidates.begin(), candidates.end());
 }
 
+
+/*
+  Return the number of abstract states of the pattern, or -1 if it is
+  larger than max_size.
+*/
+static int compute_pdb_size_up_to(
+    const TaskProxy &task_proxy, const Pattern &pattern, int max_size) {
+    int size = 1;
+    for (int var : pattern) {
+        int domain_size = task_proxy.get_variables()[var].get_domain_size();
+        if (!utils::is_product_within_limit(size, domain_size, max_size)) {
+            return -1;
+        }
+        size *= domain_size;
+    }
+    return size;
+}
+
+/*
+  Generate the same patterns as build_patterns (for interesting
+  patterns) or build_patterns_naive one size at a time, but only those
+  whose PDB has at most max_pdb_size abstract states. The limit may only
+  decrease between calls. Supersets of a pattern have larger PDBs, so
+  only patterns that can be extended within the limit are stored for
+  generating the next layers, and the patterns of the last layer are
+  never stored.
+
+  An interesting pattern of size k is an SGA pattern of size k or the
+  union of an interesting pattern P1 of size k - s with a disjoint SGA
+  pattern of size s that contains a connection point of P1, so layer k
+  only depends on the smaller layers. Likewise, the SGA patterns of
+  size k extend those of size k - 1 by an (eff, pre) neighbor. Instead
+  of collecting the unions in a set to remove duplicates, a union is
+  only reported for its first decomposition (smallest P1, see
+  has_earlier_decomposition). All decompositions of a pattern within the
+  limit consist of stored patterns, so this does not miss any pattern.
+*/
+class PatternLayers {
+    using PatternSet = utils::HashSet<Pattern>;
+
+    const TaskProxy &task_proxy;
+    const causal_graph::CausalGraph &cg;
+    const bool only_interesting_patterns;
+    const size_t max_pattern_size;
+    // Extending a pattern multiplies its PDB size by at least this factor.
+    int min_domain_size;
+    int max_pdb_size;
+    /*
+      Layer i contains the stored patterns of size i + 1 in sorted order.
+      Layers that are no longer needed are cleared.
+    */
+    vector<PatternCollection> layers;
+    /*
+      SGA layer i contains the stored SGA patterns of size i + 1 in sorted
+      order, except for the last one, which contains all SGA patterns of
+      the current size within the limit.
+    */
+    vector<PatternCollection> sga_layers;
+    // sga_layers_by_var[i][var] contains the indices of sga_layers[i] with var.
+    vector<vector<vector<int>>> sga_layers_by_var;
+
+    bool can_be_extended(const Pattern &pattern) const {
+        int pdb_size = compute_pdb_size_up_to(task_proxy, pattern, max_pdb_size);
+        return pdb_size != -1 &&
+               utils::is_product_within_limit(pdb_size, min_domain_size, max_pdb_size);
+    }
+
+    void remove_patterns_that_cannot_be_extended(PatternCollection &layer) const {
+        layer.erase(remove_if(layer.begin(), layer.end(),
+                              [this](const Pattern &pattern) {
+                                  return !can_be_extended(pattern);
+                              }), layer.end());
+    }
+
+    static bool contains(const PatternCollection &layer, const Pattern &pattern) {
+        return binary_search(layer.begin(), layer.end(), pattern);
+    }
+
+    void compute_next_sga_layer() {
+        PatternSet pattern_set;
+        if (sga_layers.empty()) {
+            for (FactProxy goal : task_proxy.get_goals()) {
+                pattern_set.insert({goal.get_variable().get_id()});
+            }
+        } else {
+            vector<int> neighbors;
+            for (const Pattern &pattern : sga_layers.back()) {
+                compute_eff_pre_neighbors(cg, pattern, neighbors);
+                for (int neighbor_var_id : neighbors) {
+                    Pattern new_pattern(pattern);
+                    new_pattern.push_back(neighbor_var_id);
+                    sort(new_pattern.begin(), new_pattern.end());
+                    if (compute_pdb_size_up_to(
+                            task_proxy, new_pattern, max_pdb_size) != -1) {
+                        pattern_set.insert(move(new_pattern));
+                    }
+                }
+            }
+        }
+        PatternCollection sga_layer(pattern_set.begin(), pattern_set.end());
+        pattern_set.clear();
+        sort(sga_layer.begin(), sga_layer.end());
+        sga_layers.push_back(move(sga_layer));
+    }
+
+    void prune_stored_layers(size_t size) {
+        for (PatternCollection &layer : layers) {
+            remove_patterns_that_cannot_be_extended(layer);
+        }
+        for (PatternCollection &sga_layer : sga_layers) {
+            remove_patterns_that_cannot_be_extended(sga_layer);
+        }
+        if (only_interesting_patterns) {
+            /*
+              SGA patterns of size s + 1 extend those of size s, so if no
+              SGA pattern of size s is stored, layer i is only needed for
+              layers up to size i + s.
+            */
+            size_t num_sga_sizes = 0;
+            while (num_sga_sizes < sga_layers.size() &&
+                   !sga_layers[num_sga_sizes].empty()) {
+                ++num_sga_sizes;
+            }
+            if (num_sga_sizes < sga_layers.size()) {
+                for (size_t i = 0; i < layers.size(); ++i) {
+                    if (size > i + 1 + num_sga_sizes) {
+                        utils::release_vector_memory(layers[i]);
+                    }
+                }
+            }
+        } else if (layers.size() >= 2) {
+            // Naive patterns only extend those of the previous size.
+            utils::release_vector_memory(layers[layers.size() - 2]);
+        }
+
+        sga_layers_by_var.clear();
+        for (const PatternCollection &sga_layer : sga_layers) {
+            vector<vector<int>> by_var(task_proxy.get_variables().size());
+            for (size_t i = 0; i < sga_layer.size(); ++i) {
+                for (int var : sga_layer[i]) {
+                    by_var[var].push_back(i);
+                }
+            }
+            sga_layers_by_var.push_back(move(by_var));
+        }
+    }
+
+    /*
+      Return true iff pattern1 is a stored interesting pattern, pattern2 a
+      stored SGA pattern and pattern2 contains a connection point of
+      pattern1.
+    */
+    bool is_decomposition(const Pattern &pattern1, const Pattern &pattern2) const {
+        if (!contains(layers[pattern1.size() - 1], pattern1) ||
+            !contains(sga_layers[pattern2.size() - 1], pattern2)) {
+            return false;
+        }
+        vector<int> neighbors;
+        compute_connection_points(cg, pattern1, neighbors);
+        for (int var : neighbors) {
+            if (binary_search(pattern2.begin(), pattern2.end(), var)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+      Return true iff pattern can be decomposed into an interesting pattern
+      P1 and an SGA pattern such that P1 is smaller than pattern1, or of
+      the same size and lexicographically smaller.
+    */
+    bool has_earlier_decomposition(
+        const Pattern &pattern, const Pattern &pattern1) const {
+        size_t size = pattern.size();
+        Pattern sub_pattern1;
+        Pattern sub_pattern2;
+        for (size_t size1 = 1; size1 <= pattern1.size(); ++size1) {
+            // Go over the subsets of size1 positions in lexicographic order.
+            vector<size_t> positions(size1);
+            for (size_t i = 0; i < size1; ++i) {
+                positions[i] = i;
+            }
+            while (true) {
+                sub_pattern1.clear();
+                sub_pattern2.clear();
+                for (size_t i = 0, j = 0; i < size; ++i) {
+                    if (j < size1 && positions[j] == i) {
+                        sub_pattern1.push_back(pattern[i]);
+                        ++j;
+                    } else {
+                        sub_pattern2.push_back(pattern[i]);
+                    }
+                }
+                if (sub_pattern1 == pattern1) {
+                    return false;
+                }
+                if (is_decomposition(sub_pattern1, sub_pattern2)) {
+                    return true;
+                }
+                // Advance to the next subset.
+                int i = size1 - 1;
+                while (i >= 0 && positions[i] == size - size1 + i) {
+                    --i;
+                }
+                if (i < 0) {
+                    break;
+                }
+                ++positions[i];
+                for (size_t j = i + 1; j < size1; ++j) {
+                    positions[j] = positions[j - 1] + 1;
+                }
+            }
+        }
+        ABORT("pattern1 is not a subset of pattern.");
+    }
+
+    /*
+      Call callback(pattern, pdb_size) for the pattern if its PDB is within
+      the limit and store it if it is needed for the next layers. Return
+      the result of the callback.
+    */
+    template<typename Callback>
+    bool report_pattern(
+        const Pattern &pattern, PatternCollection &next_layer,
+        const Callback &callback) {
+        int pdb_size = compute_pdb_size_up_to(task_proxy, pattern, max_pdb_size);
+        if (pdb_size == -1) {
+            return true;
+        }
+        if (pattern.size() < max_pattern_size && can_be_extended(pattern)) {
+            next_layer.push_back(pattern);
+        }
+        return callback(pattern, pdb_size);
+    }
+
+    template<typename Callback>
+    bool generate_interesting_layer(
+        size_t size, PatternCollection &next_layer, const Callback &callback) {
+        compute_next_sga_layer();
+        const PatternCollection &sga_layer_of_size = sga_layers.back();
+        for (const Pattern &pattern : sga_layer_of_size) {
+            if (!report_pattern(pattern, next_layer, callback)) {
+                return false;
+            }
+        }
+        vector<int> neighbors;
+        Pattern new_pattern;
+        for (size_t size1 = 1; size1 < size; ++size1) {
+            const vector<vector<int>> &sga_by_var = sga_layers_by_var[size - size1 - 1];
+            const PatternCollection &sga_layer = sga_layers[size - size1 - 1];
+            for (const Pattern &pattern1 : layers[size1 - 1]) {
+                compute_connection_points(cg, pattern1, neighbors);
+                for (size_t i = 0; i < neighbors.size(); ++i) {
+                    for (int sga_index : sga_by_var[neighbors[i]]) {
+                        const Pattern &pattern2 = sga_layer[sga_index];
+                        if (!patterns_are_disjoint(pattern1, pattern2)) {
+                            continue;
+                        }
+                        // Only use the first connection point in pattern2.
+                        bool has_earlier_connection_point = any_of(
+                            neighbors.begin(), neighbors.begin() + i,
+                            [&pattern2](int var) {
+                                return binary_search(
+                                    pattern2.begin(), pattern2.end(), var);
+                            });
+                        if (has_earlier_connection_point) {
+                            continue;
+                        }
+                        compute_union_pattern(pattern1, pattern2, new_pattern);
+                        if (compute_pdb_size_up_to(
+                                task_proxy, new_pattern, max_pdb_size) == -1 ||
+                            contains(sga_layer_of_size, new_pattern) ||
+                            has_earlier_decomposition(new_pattern, pattern1)) {
+                            continue;
+                        }
+                        if (!report_pattern(new_pattern, next_layer, callback)) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    template<typename Callback>
+    bool generate_naive_layer(
+        PatternCollection &next_layer, const Callback &callback) {
+        if (layers.empty()) {
+            int num_variables = task_proxy.get_variables().size();
+            for (int var = 0; var < num_variables; ++var) {
+                if (!report_pattern({var}, next_layer, callback)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        int num_variables = task_proxy.get_variables().size();
+        Pattern new_pattern;
+        for (const Pattern &pattern : layers.back()) {
+            for (int var = pattern.back() + 1; var < num_variables; ++var) {
+                new_pattern = pattern;
+                new_pattern.push_back(var);
+                if (!report_pattern(new_pattern, next_layer, callback)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+public:
+    PatternLayers(const TaskProxy &task_proxy, bool only_interesting_patterns,
+                  size_t max_pattern_size)
+        : task_proxy(task_proxy),
+          cg(task_proxy.get_causal_graph()),
+          only_interesting_patterns(only_interesting_patterns),
+          max_pattern_size(max_pattern_size),
+          min_domain_size(numeric_limits<int>::max()),
+          max_pdb_size(numeric_limits<int>::max()) {
+        for (VariableProxy var : task_proxy.get_variables()) {
+            min_domain_size = min(min_domain_size, var.get_domain_size());
+        }
+    }
+
+    void set_max_pdb_size(int max_size) {
+        assert(max_size <= max_pdb_size);
+        max_pdb_size = max_size;
+    }
+
+    /*
+      Call callback(pattern, pdb_size) for all patterns with one more
+      variable than in the previous call whose PDB size is at most
+      max_pdb_size. The callback returns false to stop the generation,
+      in which case this function returns false and must not be called
+      again.
+    */
+    template<typename Callback>
+    bool generate_next_layer(const Callback &callback) {
+        size_t size = layers.size() + 1;
+        assert(size <= max_pattern_size);
+        prune_stored_layers(size);
+        PatternCollection next_layer;
+        bool complete;
+        if (only_interesting_patterns) {
+            complete = generate_interesting_layer(size, next_layer, callback);
+        } else {
+            complete = generate_naive_layer(next_layer, callback);
+        }
+        sort(next_layer.begin(), next_layer.end());
+        layers.push_back(move(next_layer));
+        return complete;
+    }
+};
+
+/*
+  Return true iff every abstract state of pdb has the same value as its
+  projection to the pattern of sub_pdb, which must be a subset of the
+  pattern of pdb.
+*/
+static bool has_same_values(
+    const PatternDatabase &pdb, const PatternDatabase &sub_pdb,
+    const TaskProxy &task_proxy) {
+    const Pattern &pattern = pdb.get_pattern();
+    const Pattern &sub_pattern = sub_pdb.get_pattern();
+    VariablesProxy variables = task_proxy.get_variables();
+    struct Digit {
+        int domain_size;
+        // Multiplier of the variable in sub_pdb, or 0 if it is projected away.
+        int sub_multiplier;
+        int value;
+    };
+    vector<Digit> digits;
+    digits.reserve(pattern.size());
+    for (size_t i = 0, j = 0; i < pattern.size(); ++i) {
+        int sub_multiplier = 0;
+        if (j < sub_pattern.size() && sub_pattern[j] == pattern[i]) {
+            sub_multiplier = sub_pdb.get_hash_multipliers()[j];
+            ++j;
+        }
+        digits.push_back({variables[pattern[i]].get_domain_size(), sub_multiplier, 0});
+    }
+    const DistanceTable &distances = pdb.get_distances();
+    const DistanceTable &sub_distances = sub_pdb.get_distances();
+    // Go over the abstract states of pdb in order of their indices.
+    int sub_index = 0;
+    for (int index = 0; index < pdb.get_size(); ++index) {
+        if (distances[index] != sub_distances[sub_index]) {
+            return false;
+        }
+        for (Digit &digit : digits) {
+            if (++digit.value < digit.domain_size) {
+                sub_index += digit.sub_multiplier;
+                break;
+            }
+            sub_index -= (digit.domain_size - 1) * digit.sub_multiplier;
+            digit.value = 0;
+        }
+    }
+    return true;
+}
+
+PatternCollectionGeneratorSystematic::PatternCollectionGeneratorSystematic(
+    const Options &opts)
+    : PatternCollectionGenerator(opts),
+      max_pattern_size(opts.get<int>("pattern_max_size")),
+      only_interesting_patterns(opts.get<bool>("only_interesting_patterns")),
+      streaming(opts.get<bool>("streaming")),
+      pdb_max_size(opts.get<int>("pdb_max_size")),
+      collection_max_size(opts.get<int>("collection_max_size")),
+      max_time(opts.get<double>("max_time")) {
+}
+
 void PatternCollectionGeneratorSystematic::enqueue_pattern_if_new(
     const Pattern &pattern) {
     if (pattern_set.insert(pattern).second)
@@ -261,11 +675,146 @@ void PatternCollectionGeneratorSystematic::build_patterns_naive(
     utils::g_log << "Found " << patterns->size() << " patterns." << endl;
 }
 
+PatternCollectionInformation PatternCollectionGeneratorSystematic::generate_streaming(
+    const TaskProxy &task_proxy) {
+    /*
+      The PDBs are computed in chunks of this many patterns, which are
+      selected assuming that all of their PDBs are kept. The chunks do
+      not depend on the number of threads, so neither does the result
+      (unless max_time is reached).
+    */
+    const size_t chunk_size = 64;
+    utils::CountdownTimer timer(max_time);
+    PatternLayers pattern_layers(
+        task_proxy, only_interesting_patterns, max_pattern_size);
+    patterns = make_shared<PatternCollection>();
+    shared_ptr<PDBCollection> pdbs = make_shared<PDBCollection>();
+
+    /*
+      min_pdb_sizes[i] is the smallest PDB size of a pattern with i
+      variables, or -1 if it exceeds the collection size limit.
+    */
+    vector<int> domain_sizes;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        domain_sizes.push_back(var.get_domain_size());
+    }
+    sort(domain_sizes.begin(), domain_sizes.end());
+    vector<int> min_pdb_sizes(1, 1);
+    for (size_t i = 0; i < min(domain_sizes.size(), max_pattern_size); ++i) {
+        int size = min_pdb_sizes.back();
+        min_pdb_sizes.push_back(
+            size != -1 && utils::is_product_within_limit(
+                size, domain_sizes[i], collection_max_size)
+            ? size * domain_sizes[i] : -1);
+    }
+    int collection_size = 0;
+    auto get_max_pdb_size = [&]() {
+        return min(pdb_max_size, collection_max_size - collection_size);
+    };
+    auto can_add_pdb = [&](size_t pattern_size) {
+        return pattern_size < min_pdb_sizes.size() &&
+               min_pdb_sizes[pattern_size] != -1 &&
+               min_pdb_sizes[pattern_size] <= get_max_pdb_size();
+    };
+
+    /*
+      Map the patterns of the computed PDBs of the previous and the
+      current size to the index of the kept PDB with the same values
+      (their own or that of a subpattern).
+    */
+    utils::HashMap<Pattern, int> previous_pdb_indices;
+    utils::HashMap<Pattern, int> pdb_indices;
+    PatternCollection chunk;
+    int chunk_pdb_size = 0;
+    int num_generated = 0;
+    int num_skipped = 0;
+    int num_dropped = 0;
+    auto compute_chunk = [&]() {
+        if (chunk.empty()) {
+            return;
+        }
+        PDBCollection chunk_pdbs = compute_pdbs(
+            task_proxy, chunk, num_threads, pdb_cache);
+        for (size_t i = 0; i < chunk.size(); ++i) {
+            const Pattern &pattern = chunk[i];
+            int pdb_index = -1;
+            Pattern sub_pattern;
+            for (size_t j = 0; j < pattern.size() && pdb_index == -1; ++j) {
+                sub_pattern = pattern;
+                sub_pattern.erase(sub_pattern.begin() + j);
+                auto it = previous_pdb_indices.find(sub_pattern);
+                if (it != previous_pdb_indices.end() &&
+                    has_same_values(*chunk_pdbs[i], *(*pdbs)[it->second],
+                                    task_proxy)) {
+                    pdb_index = it->second;
+                }
+            }
+            if (pdb_index == -1) {
+                pdb_index = pdbs->size();
+                collection_size += chunk_pdbs[i]->get_size();
+                patterns->push_back(pattern);
+                pdbs->push_back(move(chunk_pdbs[i]));
+            } else {
+                ++num_dropped;
+            }
+            pdb_indices[pattern] = pdb_index;
+        }
+        chunk.clear();
+        chunk_pdb_size = 0;
+        pattern_layers.set_max_pdb_size(get_max_pdb_size());
+    };
+
+    pattern_layers.set_max_pdb_size(get_max_pdb_size());
+    bool limit_reached = false;
+    for (size_t size = 1; size <= max_pattern_size && !limit_reached; ++size) {
+        if (timer.is_expired() || !can_add_pdb(size)) {
+            break;
+        }
+        limit_reached = !pattern_layers.generate_next_layer(
+            [&](const Pattern &pattern, int pdb_size) {
+                ++num_generated;
+                if (pdb_size > get_max_pdb_size() - chunk_pdb_size) {
+                    ++num_skipped;
+                } else {
+                    chunk.push_back(pattern);
+                    chunk_pdb_size += pdb_size;
+                }
+                if (chunk.size() == chunk_size) {
+                    compute_chunk();
+                    return !timer.is_expired() && can_add_pdb(size);
+                }
+                return true;
+            });
+        compute_chunk();
+        previous_pdb_indices.swap(pdb_indices);
+        pdb_indices.clear();
+    }
+    if (timer.is_expired()) {
+        utils::g_log << "Time limit reached. Abort systematic pattern generation."
+                     << endl;
+    }
+    utils::g_log << "Generated " << num_generated << " patterns within the "
+                 << "PDB size limit, skipped " << num_skipped << " because of "
+                 << "the collection size limit, dropped " << num_dropped
+                 << " with the same values as a subpattern." << endl;
+
+    PatternCollectionInformation pci(
+        task_proxy, patterns, num_threads, pdb_cache);
+    pci.set_pdbs(pdbs);
+    return pci;
+}
+
 PatternCollectionInformation PatternCollectionGeneratorSystematic::generate(
     const shared_ptr<AbstractTask> &task) {
     utils::Timer timer;
     utils::g_log << "Generating patterns using the systematic generator..." << endl;
     TaskProxy task_proxy(*task);
+    if (streaming) {
+        PatternCollectionInformation pci = generate_streaming(task_proxy);
+        dump_pattern_collection_generation_statistics(
+            "Systematic generator", timer(), pci);
+        return pci;
+    }
     patterns = make_shared<PatternCollection>();
     pattern_set.clear();
     if (only_interesting_patterns) {
@@ -273,7 +822,8 @@ PatternCollectionInformation PatternCollectionGeneratorSystematic::generate(
     } else {
         build_patterns_naive(task_proxy);
     }
-    PatternCollectionInformation pci(task_proxy, patterns);
+    PatternCollectionInformation pci(
+        task_proxy, patterns, num_threads, pdb_cache);
     /* Do not dump the collection since it can be very large for
        pattern_max_size >= 3. */
     dump_pattern_collection_generation_statistics(
@@ -306,6 +856,34 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "Only consider the union of two disjoint patterns if the union has "
         "more information than the individual patterns.",
         "true");
+    parser.add_option<bool>(
+        "streaming",
+        "generate the patterns one size at a time and compute their PDBs "
+        "right away, subject to the following limits, instead of "
+        "generating all patterns first. PDBs whose values equal those of "
+        "a PDB for a subpattern are dropped.",
+        "false");
+    parser.add_option<int>(
+        "pdb_max_size",
+        "maximal number of states per pattern database (only used with "
+        "streaming=true)",
+        "infinity",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "collection_max_size",
+        "maximal number of states in the pattern collection (only used "
+        "with streaming=true). The generation stops once no PDB of the "
+        "current pattern size fits into the remaining size.",
+        "infinity",
+        Bounds("1", "infinity"));
+    parser.add_option<double>(
+        "max_time",
+        "maximum time in seconds for generating patterns and computing "
+        "their PDBs (only used with streaming=true). When it is reached, "
+        "the PDBs computed so far are used.",
+        "infinity",
+        Bounds("0.0", "infinity"));
+    add_generator_options_to_parser(parser);
 
     Options opts = parser.parse();
     if (parser.dry_run())
@@ -23,27 +23,42 @@ class Options;
 
 namespace pdbs {
 class CanonicalPDBsHeuristic;
+class PatternDatabase;
 
-// Invariant: patterns are always sorted.
+/*
+  Invariant: patterns are always sorted.
+
+  By default, all patterns are generated first and their PDBs are
+  computed afterwards. In streaming mode, the patterns are generated one
+  size at a time (see PatternLayers in the .cc file) and their PDBs are
+  computed in chunks right away. Patterns whose PDB does not fit into
+  the pdb_max_size and collection_max_size limits are never generated,
+  only patterns that can be extended within the limits are stored for
+  generating larger patterns, and the generation stops once no PDB of
+  the current size fits into the remaining collection size or max_time
+  is reached. A PDB is dropped if its values are equal to the values of
+  a kept PDB for a subpattern: it can then be replaced by this PDB in
+  every additive subset without changing the heuristic.
+*/
 class PatternCollectionGeneratorSystematic : public PatternCollectionGenerator {
     using PatternSet = utils::HashSet<Pattern>;
 
     const size_t max_pattern_size;
     const bool only_interesting_patterns;
+    const bool streaming;
+    const int pdb_max_size;
+    const int collection_max_size;
+    const double max_time;
     std::shared_ptr<PatternCollection> patterns;
     PatternSet pattern_set;  // Cleared after pattern computation.
 
     void enqueue_pattern_if_new(const Pattern &pattern);
-    void compute_eff_pre_neighbors(const causal_graph::CausalGraph &cg,
-                                   const Pattern &pattern,
-                                   std::vector<int> &result) const;
-    void compute_connection_points(const causal_graph::CausalGraph &cg,
-                                   const Pattern &pattern,
-                                   std::vector<int> &result) const;
 
     void build_sga_patterns(const TaskProxy &task_proxy, const causal_graph::CausalGraph &cg);
     void build_patterns(const TaskProxy &task_proxy);
     void build_patterns_naive(const TaskProxy &task_proxy);
+
+    PatternCollectionInformation generate_streaming(const TaskProxy &task_proxy);
 public:
     explicit PatternCollectionGeneratorSystematic(const options::Options &opts);
 
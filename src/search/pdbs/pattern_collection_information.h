@@ -8,6 +8,8 @@
 #include <memory>
 
 namespace pdbs {
+class PDBCache;
+
 /*
   This class contains everything we know about a pattern collection. It will
   always contain patterns, but can also contain the computed PDBs and maximal
@@ -25,6 +27,9 @@ class PatternCollectionInformation {
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    // Maximum number of threads for computing missing PDBs.
+    int num_threads;
+    std::shared_ptr<PDBCache> pdb_cache;
 
     void create_pdbs_if_missing();
     void create_pattern_cliques_if_missing();
@@ -33,7 +38,9 @@ class PatternCollectionInformation {
 public:
     PatternCollectionInformation(
         const TaskProxy &task_proxy,
-        const std::shared_ptr<PatternCollection> &patterns);
+        const std::shared_ptr<PatternCollection> &patterns,
+        int num_threads = 1,
+        const std::shared_ptr<PDBCache> &pdb_cache = nullptr);
     ~PatternCollectionInformation() = default;
 
     void set_pdbs(const std::shared_ptr<PDBCollection> &pdbs);
@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_DATABASE_H
 #define PDBS_PATTERN_DATABASE_H
 
+#include "distance_table.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -13,6 +14,9 @@ class RandomNumberGenerator;
 }
 
 namespace pdbs {
+class MatchTree;
+class PDBCache;
+
 class AbstractOperator {
     /*
       This class represents an abstract operator how it is needed for
@@ -90,7 +94,7 @@ class PatternDatabase {
       final h-values for abstract-states.
       dead-ends are represented by numeric_limits<int>::max()
     */
-    std::vector<int> distances;
+    DistanceTable distances;
 
     std::vector<int> generating_op_ids;
     std::vector<std::vector<OperatorID>> wildcard_plan;
@@ -129,8 +133,10 @@ class PatternDatabase {
 
     /*
       Computes all abstract operators, builds the match tree (successor
-      generator) and then does a Dijkstra regression search to compute
-      all final h-values (stored in distances). operator_costs can
+      generator) and then does a regression search to compute all final
+      h-values (stored in distances). The search is layered if all
+      operators have small positive costs and no plan is needed, and
+      Dijkstra otherwise. operator_costs can
       specify individual operator costs for each operator for action
       cost partitioning. If left empty, default operator costs are used.
     */
@@ -139,7 +145,36 @@ class PatternDatabase {
         const std::vector<int> &operator_costs,
         bool compute_plan,
         const std::shared_ptr<utils::RandomNumberGenerator> &rng,
-        bool compute_wildcard_plan);
+        bool compute_wildcard_plan,
+        PDBCache *pdb_cache);
+
+    /*
+      Returns a description of the projection that determines all goal
+      distances: the domain sizes of the pattern variables, the abstract
+      goals and the regression preconditions, hash effects and costs of
+      all abstract operators in a canonical order. Projections with equal
+      keys have equal distance tables.
+    */
+    std::vector<int> compute_cache_key(
+        const std::vector<AbstractOperator> &operators,
+        const std::vector<FactPair> &abstract_goals,
+        const VariablesProxy &variables) const;
+
+    /*
+      Computes the goal distances with a search that expands one distance
+      layer at a time. distances must be 0 for the given goal states and
+      numeric_limits<int>::max() for all other states. All operators must
+      cost between 1 and max_cost. Large layers are expanded with one
+      strided pass over the states matching each abstract operator
+      instead of one match tree query per state.
+    */
+    void compute_distances_by_layers(
+        const std::vector<AbstractOperator> &operators,
+        const MatchTree &match_tree,
+        const VariablesProxy &variables,
+        const std::vector<int> &goal_states,
+        int max_cost,
+        std::vector<int> &distances) const;
 
     /*
       For a given abstract state (given as index), the according values
@@ -173,6 +208,8 @@ public:
        compute_wildcard_plan: when computing a plan (see compute_plan), compute
        a wildcard plan, i.e., a sequence of parallel operators inducing an
        optimal plan. Otherwise, compute a simple plan (a sequence of operators).
+       pdb_cache: if given, the distances are loaded from and stored in
+       this cache. PDBs that compute a plan do not use the cache.
     */
     PatternDatabase(
         const TaskProxy &task_proxy,
@@ -181,11 +218,20 @@ public:
         const std::vector<int> &operator_costs = std::vector<int>(),
         bool compute_plan = false,
         const std::shared_ptr<utils::RandomNumberGenerator> &rng = nullptr,
-        bool compute_wildcard_plan = false);
+        bool compute_wildcard_plan = false,
+        const std::shared_ptr<PDBCache> &pdb_cache = nullptr);
     ~PatternDatabase() = default;
 
     int get_value(const std::vector<int> &state) const;
 
+    /*
+      Append the values of all given states, which must be unpacked, to
+      values. All hash indices are computed before the first table lookup,
+      so the (often cache-missing) lookups for different states overlap.
+    */
+    void get_values(
+        const std::vector<State> &states, std::vector<int> &values) const;
+
     // Returns the pattern (i.e. all variables used) of the PDB
     const Pattern &get_pattern() const {
         return pattern;
@@ -196,6 +242,19 @@ public:
         return num_states;
     }
 
+    /*
+      Returns the multipliers of the perfect hash function, in the order
+      of the pattern variables, and the distances indexed by it. Together
+      they allow computing the hash index of a state elsewhere.
+    */
+    const std::vector<int> &get_hash_multipliers() const {
+        return hash_multipliers;
+    }
+
+    const DistanceTable &get_distances() const {
+        return distances;
+    }
+
     std::vector<std::vector<OperatorID>> && extract_wildcard_plan() {
         return std::move(wildcard_plan);
     };
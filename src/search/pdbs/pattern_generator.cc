@@ -1,8 +1,55 @@
 #include "pattern_generator.h"
 
+#include "pdb_cache.h"
+
+#include "../option_parser.h"
 #include "../plugin.h"
 
+using namespace std;
+
 namespace pdbs {
+static shared_ptr<PDBCache> create_pdb_cache(const Options &opts) {
+    if (opts.contains("pdb_cache_directory")) {
+        return make_shared<PDBCache>(opts.get<string>("pdb_cache_directory"));
+    }
+    return nullptr;
+}
+
+PatternCollectionGenerator::PatternCollectionGenerator(
+    const Options &opts)
+    : num_threads(opts.get<int>("threads")),
+      pdb_cache(create_pdb_cache(opts)) {
+}
+
+void add_generator_options_to_parser(OptionParser &parser) {
+    parser.add_option<int>(
+        "threads",
+        "maximum number of threads for computing the pattern databases of "
+        "the pattern collection (and of candidate collections during pattern "
+        "generation). hillclimbing also uses the threads to evaluate its "
+        "candidate patterns on the sample states. The generated patterns do "
+        "not depend on this number. "
+        "single_cegar uses the threads to execute the plans of its patterns; "
+        "its result does not depend on the number of threads either. "
+        "multiple_cegar performs this many CEGAR runs concurrently, so its "
+        "result depends on the number of threads.",
+        "1",
+        Bounds("1", "infinity"));
+    parser.add_option<string>(
+        "pdb_cache_directory",
+        "directory for a persistent cache of pattern databases. Before "
+        "computing a pattern database, the planner looks for a file with "
+        "the distances of an identical projection (same variable domains, "
+        "goals, abstract operators and operator costs) in this directory "
+        "and maps it into memory instead. Newly computed pattern databases "
+        "are added to the cache, so later runs on tasks of the same domain "
+        "can reuse them. The directory is created if it does not exist. "
+        "The pattern databases computed by the CEGAR-based generators and "
+        "by zero-one cost partitioning do not use the cache. Not supported "
+        "on Windows.",
+        OptionParser::NONE);
+}
+
 static PluginTypePlugin<PatternCollectionGenerator> _type_plugin_collection(
     "PatternCollectionGenerator",
     "Factory for pattern collections");
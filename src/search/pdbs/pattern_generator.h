@@ -9,9 +9,22 @@
 
 class AbstractTask;
 
+namespace options {
+class OptionParser;
+class Options;
+}
+
 namespace pdbs {
+class PDBCache;
+
 class PatternCollectionGenerator {
+protected:
+    // Maximum number of threads used for computing PDBs.
+    const int num_threads;
+    // Persistent cache for PDBs, or nullptr if PDBs are not cached.
+    const std::shared_ptr<PDBCache> pdb_cache;
 public:
+    explicit PatternCollectionGenerator(const options::Options &opts);
     virtual ~PatternCollectionGenerator() = default;
 
     virtual PatternCollectionInformation generate(
@@ -24,6 +37,8 @@ public:
 
     virtual PatternInformation generate(const std::shared_ptr<AbstractTask> &task) = 0;
 };
+
+extern void add_generator_options_to_parser(options::OptionParser &parser);
 }
 
 #endif
@@ -0,0 +1,231 @@
+#include "pdb_cache.h"
+
+#include "distance_table.h"
+
+#include "../utils/hash.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+#include "../utils/timer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace pdbs {
+/*
+  Increase the version whenever the file layout or the meaning of the
+  stored distances changes, so that old files are treated as misses.
+*/
+static const uint32_t CACHE_FILE_VERSION = 1;
+static const char CACHE_FILE_MAGIC[8] = {'F', 'D', 'P', 'D', 'B', 'C', '\0', '\0'};
+
+/*
+  Layout of a cache file: the header, the key (key_size ints) and, from
+  data_offset on, the data block of the distance table.
+*/
+struct CacheFileHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t key_size;
+    int32_t bytes_per_entry;
+    int32_t num_entries;
+    int32_t num_escaped;
+    uint32_t padding;
+    uint64_t data_offset;
+};
+
+static uint64_t get_data_offset(size_t key_size) {
+    const size_t alignment = 8;
+    size_t end_of_key = sizeof(CacheFileHeader) + key_size * sizeof(int);
+    return (end_of_key + alignment - 1) / alignment * alignment;
+}
+
+string PDBCache::get_path(const vector<int> &key) const {
+    ostringstream path;
+    path << directory << "/pdb-" << hex << setw(16) << setfill('0')
+         << utils::get_hash64(key) << ".bin";
+    return path.str();
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+PDBCache::PDBCache(const string &directory)
+    : directory(directory),
+      num_hits(0),
+      num_misses(0),
+      load_time(0) {
+    if (mkdir(directory.c_str(), 0777) == -1 && errno != EEXIST) {
+        cerr << "PDB cache: creating " << directory << " failed: "
+             << strerror(errno) << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    utils::g_log << "Using PDB cache in " << directory << endl;
+}
+
+static bool is_valid_cache_file(
+    const char *file, size_t file_size, const vector<int> &key) {
+    if (file_size < sizeof(CacheFileHeader)) {
+        return false;
+    }
+    CacheFileHeader header;
+    memcpy(&header, file, sizeof(header));
+    if (memcmp(header.magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC)) != 0 ||
+        header.version != CACHE_FILE_VERSION ||
+        header.key_size != static_cast<int>(key.size()) ||
+        header.data_offset != get_data_offset(key.size())) {
+        return false;
+    }
+    if (header.bytes_per_entry != 1 && header.bytes_per_entry != 2 &&
+        header.bytes_per_entry != 4) {
+        return false;
+    }
+    size_t data_size = DistanceTable::compute_memory_in_bytes(
+        header.bytes_per_entry, header.num_entries, header.num_escaped);
+    if (header.data_offset + data_size != file_size) {
+        return false;
+    }
+    return memcmp(file + sizeof(CacheFileHeader), key.data(),
+                  key.size() * sizeof(int)) == 0;
+}
+
+bool PDBCache::load(const vector<int> &key, DistanceTable &distances) {
+    utils::Timer timer;
+    bool found = false;
+    int file_descriptor = open(get_path(key).c_str(), O_RDONLY);
+    if (file_descriptor != -1) {
+        struct stat file_status;
+        void *file = MAP_FAILED;
+        size_t file_size = 0;
+        if (fstat(file_descriptor, &file_status) == 0 && file_status.st_size > 0) {
+            file_size = file_status.st_size;
+            file = mmap(nullptr, file_size, PROT_READ, MAP_SHARED,
+                        file_descriptor, 0);
+        }
+        // The mapping stays valid after closing the file.
+        close(file_descriptor);
+        if (file != MAP_FAILED) {
+            const char *begin = static_cast<const char *>(file);
+            if (is_valid_cache_file(begin, file_size, key)) {
+                CacheFileHeader header;
+                memcpy(&header, begin, sizeof(header));
+                shared_ptr<const char> mapping(
+                    begin, [file_size](const char *p) {
+                        munmap(const_cast<char *>(p), file_size);
+                    });
+                distances = DistanceTable(
+                    header.bytes_per_entry, header.num_entries,
+                    header.num_escaped,
+                    shared_ptr<const char>(mapping, begin + header.data_offset));
+                found = true;
+            } else {
+                munmap(file, file_size);
+            }
+        }
+    }
+
+    lock_guard<mutex> lock(statistics_mutex);
+    if (found) {
+        ++num_hits;
+    } else {
+        ++num_misses;
+    }
+    load_time += timer();
+    return found;
+}
+
+static bool write_all(int file_descriptor, const char *buffer, size_t num_bytes) {
+    while (num_bytes > 0) {
+        ssize_t written = write(file_descriptor, buffer, num_bytes);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        buffer += written;
+        num_bytes -= written;
+    }
+    return true;
+}
+
+void PDBCache::store(const vector<int> &key, const DistanceTable &distances) {
+    CacheFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, CACHE_FILE_MAGIC, sizeof(CACHE_FILE_MAGIC));
+    header.version = CACHE_FILE_VERSION;
+    header.key_size = key.size();
+    header.bytes_per_entry = distances.get_bytes_per_entry();
+    header.num_entries = distances.size();
+    header.num_escaped = distances.get_num_escaped();
+    header.data_offset = get_data_offset(key.size());
+    const char padding[8] = {};
+    size_t num_padding_bytes =
+        header.data_offset - sizeof(header) - key.size() * sizeof(int);
+
+    string path_template = directory + "/.pdb-XXXXXX";
+    vector<char> temp_path(path_template.begin(), path_template.end());
+    temp_path.push_back('\0');
+    int file_descriptor = mkstemp(temp_path.data());
+    bool success = file_descriptor != -1;
+    if (success) {
+        success =
+            write_all(file_descriptor, reinterpret_cast<const char *>(&header),
+                      sizeof(header)) &&
+            write_all(file_descriptor, reinterpret_cast<const char *>(key.data()),
+                      key.size() * sizeof(int)) &&
+            write_all(file_descriptor, padding, num_padding_bytes) &&
+            write_all(file_descriptor, distances.get_data(),
+                      distances.get_memory_in_bytes());
+        success = close(file_descriptor) == 0 && success;
+        // Other runs only ever see complete files under the final name.
+        success = success &&
+            rename(temp_path.data(), get_path(key).c_str()) == 0;
+        if (!success) {
+            unlink(temp_path.data());
+        }
+    }
+    if (!success) {
+        lock_guard<mutex> lock(statistics_mutex);
+        utils::g_log << "Warning: writing to the PDB cache failed: "
+                     << strerror(errno) << endl;
+    }
+}
+#else
+PDBCache::PDBCache(const string &directory)
+    : directory(directory),
+      num_hits(0),
+      num_misses(0),
+      load_time(0) {
+    cerr << "The PDB cache is not supported on this operating system."
+         << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+}
+
+bool PDBCache::load(const vector<int> &, DistanceTable &) {
+    ABORT("The PDB cache is not supported on this operating system.");
+}
+
+void PDBCache::store(const vector<int> &, const DistanceTable &) {
+    ABORT("The PDB cache is not supported on this operating system.");
+}
+#endif
+
+void PDBCache::dump_statistics() const {
+    lock_guard<mutex> lock(statistics_mutex);
+    utils::g_log << "PDB cache: " << num_hits << " hits, " << num_misses
+                 << " misses, load time: " << load_time << "s" << endl;
+}
+}
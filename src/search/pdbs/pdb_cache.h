@@ -0,0 +1,48 @@
+#ifndef PDBS_PDB_CACHE_H
+#define PDBS_PDB_CACHE_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace pdbs {
+class DistanceTable;
+
+/*
+  Persistent cache of PDB distance tables in a directory on disk.
+
+  Each table is stored in its own file together with a key that
+  describes the projection the table was computed for (see
+  PatternDatabase::compute_cache_key). The file name is derived from a
+  hash of the key, and the full key is compared when loading, so hash
+  collisions only lead to cache misses. Loading maps the file into memory
+  and uses the mapped data directly, without copying it. Files are
+  written to a temporary name and renamed, so concurrent planner runs
+  using the same directory never see partially written files.
+
+  All methods may be called from several threads at once.
+
+  The cache is only supported on Linux and macOS.
+*/
+class PDBCache {
+    const std::string directory;
+
+    mutable std::mutex statistics_mutex;
+    int num_hits;
+    int num_misses;
+    double load_time;
+
+    std::string get_path(const std::vector<int> &key) const;
+public:
+    explicit PDBCache(const std::string &directory);
+
+    // Set distances and return true if the cache has a table for key.
+    bool load(const std::vector<int> &key, DistanceTable &distances);
+
+    void store(const std::vector<int> &key, const DistanceTable &distances);
+
+    void dump_statistics() const;
+};
+}
+
+#endif
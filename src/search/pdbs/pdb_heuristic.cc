@@ -1,11 +1,14 @@
 #include "pdb_heuristic.h"
 
+#include "distance_table.h"
 #include "pattern_database.h"
 #include "pattern_generator.h"
 
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../utils/memory.h"
+
 #include <limits>
 #include <memory>
 
@@ -25,14 +28,67 @@ PDBHeuristic::PDBHeuristic(const Options &opts)
       pdb(get_pdb_from_options(task, opts)) {
 }
 
+const PackedHashPlan &PDBHeuristic::get_packed_hash_plan(
+    const int_packer::IntPacker &state_packer) {
+    if (!packed_hash_plan ||
+        &packed_hash_plan->get_state_packer() != &state_packer) {
+        packed_hash_plan = utils::make_unique_ptr<PackedHashPlan>(
+            PDBCollection {pdb}, state_packer);
+    }
+    return *packed_hash_plan;
+}
+
 int PDBHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-    int h = pdb->get_value(state.get_unpacked_values());
+    const int_packer::IntPacker *state_packer = get_state_packer(ancestor_state);
+    int h;
+    if (state_packer) {
+        const PackedHashPlan &plan = get_packed_hash_plan(*state_packer);
+        h = pdb->get_distances()[
+            plan.get_hash_index(0, ancestor_state.get_buffer())];
+    } else {
+        State state = convert_ancestor_state(ancestor_state);
+        h = pdb->get_value(state.get_unpacked_values());
+    }
     if (h == numeric_limits<int>::max())
         return DEAD_END;
     return h;
 }
 
+void PDBHeuristic::compute_results(vector<StateEvaluationContext> &batch) {
+    compute_batch_results(batch);
+}
+
+bool PDBHeuristic::supports_batch_evaluation() const {
+    return true;
+}
+
+void PDBHeuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &heuristics) {
+    size_t first = heuristics.size();
+    const int_packer::IntPacker *state_packer = get_state_packer(ancestor_states);
+    if (state_packer) {
+        const PackedHashPlan &plan = get_packed_hash_plan(*state_packer);
+        for (const State &ancestor_state : ancestor_states) {
+            heuristics.push_back(
+                plan.get_hash_index(0, ancestor_state.get_buffer()));
+        }
+        pdb->get_distances().lookup(
+            heuristics.data() + first, heuristics.size() - first);
+    } else {
+        vector<State> states;
+        states.reserve(ancestor_states.size());
+        for (const State &ancestor_state : ancestor_states) {
+            states.push_back(convert_ancestor_state(ancestor_state));
+            states.back().unpack();
+        }
+        pdb->get_values(states, heuristics);
+    }
+    for (size_t i = first; i < heuristics.size(); ++i) {
+        if (heuristics[i] == numeric_limits<int>::max())
+            heuristics[i] = DEAD_END;
+    }
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("Pattern database heuristic", "TODO");
     parser.document_language_support("action costs", "supported");
@@ -1,6 +1,8 @@
 #ifndef PDBS_PDB_HEURISTIC_H
 #define PDBS_PDB_HEURISTIC_H
 
+#include "packed_hash_plan.h"
+
 #include "../heuristic.h"
 
 namespace options {
@@ -13,8 +15,16 @@ class PatternDatabase;
 // Implements a heuristic for a single PDB.
 class PDBHeuristic : public Heuristic {
     std::shared_ptr<PatternDatabase> pdb;
+    // Used for looking up registered states without unpacking them.
+    std::unique_ptr<PackedHashPlan> packed_hash_plan;
+
+    const PackedHashPlan &get_packed_hash_plan(
+        const int_packer::IntPacker &state_packer);
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states,
+        std::vector<int> &heuristics) override;
 public:
     /*
       Important: It is assumed that the pattern (passed via Options) is
@@ -27,6 +37,10 @@ public:
     */
     PDBHeuristic(const options::Options &opts);
     virtual ~PDBHeuristic() override = default;
+
+    virtual void compute_results(
+        std::vector<StateEvaluationContext> &batch) override;
+    virtual bool supports_batch_evaluation() const override;
 };
 }
 
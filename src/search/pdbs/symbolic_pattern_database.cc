@@ -0,0 +1,249 @@
+#include "symbolic_pattern_database.h"
+
+#include "../task_utils/task_properties.h"
+#include "../utils/collections.h"
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+
+using namespace std;
+using decision_diagrams::DDManager;
+using decision_diagrams::NodeID;
+
+namespace pdbs {
+SymbolicPatternDatabase::SymbolicPatternDatabase(
+    const TaskProxy &task_proxy,
+    const Pattern &pattern,
+    const vector<int> &operator_costs)
+    : pattern(pattern) {
+    task_properties::verify_no_axioms(task_proxy);
+    task_properties::verify_no_conditional_effects(task_proxy);
+    assert(operator_costs.empty() ||
+           operator_costs.size() == task_proxy.get_operators().size());
+    assert(utils::is_sorted_unique(pattern));
+
+    VariablesProxy variables = task_proxy.get_variables();
+    for (int var : pattern) {
+        int domain_size = variables[var].get_domain_size();
+        int bits = 0;
+        while ((1 << bits) < domain_size) {
+            ++bits;
+        }
+        first_binary_vars.push_back(binary_var_to_var.size());
+        num_bits.push_back(bits);
+        for (int bit = 0; bit < bits; ++bit) {
+            binary_var_to_var.push_back(var);
+            binary_var_to_shift.push_back(bits - 1 - bit);
+        }
+    }
+    manager = utils::make_unique_ptr<DDManager>(binary_var_to_var.size());
+    compute_distances(task_proxy, operator_costs);
+}
+
+void SymbolicPatternDatabase::set_fact(
+    int pattern_index, int value, vector<int> &assignment) const {
+    int first = first_binary_vars[pattern_index];
+    int bits = num_bits[pattern_index];
+    for (int bit = 0; bit < bits; ++bit) {
+        assignment[first + bit] = (value >> (bits - 1 - bit)) & 1;
+    }
+}
+
+NodeID SymbolicPatternDatabase::build_valid_states_bdd(
+    const VariablesProxy &variables) {
+    int num_binary_vars = manager->get_num_variables();
+    NodeID valid_states = DDManager::TRUE_NODE;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        int domain_size = variables[pattern[i]].get_domain_size();
+        if (domain_size == 1 << num_bits[i]) {
+            // All encodings represent values.
+            continue;
+        }
+        NodeID valid_values = DDManager::FALSE_NODE;
+        for (int value = 0; value < domain_size; ++value) {
+            vector<int> assignment(num_binary_vars, -1);
+            set_fact(i, value, assignment);
+            valid_values = manager->apply_or(
+                valid_values, manager->make_cube(assignment));
+        }
+        valid_states = manager->apply_and(valid_states, valid_values);
+    }
+    return valid_states;
+}
+
+vector<SymbolicPatternDatabase::RegressionOperator>
+SymbolicPatternDatabase::build_regression_operators(
+    const TaskProxy &task_proxy, const vector<int> &operator_costs) {
+    int num_binary_vars = manager->get_num_variables();
+    vector<int> variable_to_index(task_proxy.get_variables().size(), -1);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        variable_to_index[pattern[i]] = i;
+    }
+
+    /*
+      Operators with the same cost and effect only differ in the states
+      they can be applied in, so we merge them into one operator whose
+      precondition is the union of their preconditions.
+    */
+    map<pair<int, NodeID>, NodeID> preconditions_by_cost_and_effect;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        vector<int> effect(num_binary_vars, -1);
+        bool is_relevant = false;
+        for (EffectProxy eff : op.get_effects()) {
+            FactPair fact = eff.get_fact().get_pair();
+            int pattern_index = variable_to_index[fact.var];
+            if (pattern_index != -1) {
+                set_fact(pattern_index, fact.value, effect);
+                is_relevant = true;
+            }
+        }
+        // Operators without effects on the pattern only induce self-loops.
+        if (!is_relevant) {
+            continue;
+        }
+        vector<int> precondition(num_binary_vars, -1);
+        for (FactProxy pre : op.get_preconditions()) {
+            FactPair fact = pre.get_pair();
+            int pattern_index = variable_to_index[fact.var];
+            if (pattern_index != -1) {
+                set_fact(pattern_index, fact.value, precondition);
+            }
+        }
+        int cost = operator_costs.empty() ?
+            op.get_cost() : operator_costs[op.get_id()];
+        NodeID &merged_precondition = preconditions_by_cost_and_effect.insert(
+            make_pair(make_pair(cost, manager->make_cube(effect)),
+                      DDManager::FALSE_NODE)).first->second;
+        merged_precondition = manager->apply_or(
+            merged_precondition, manager->make_cube(precondition));
+    }
+
+    vector<RegressionOperator> operators;
+    for (const auto &entry : preconditions_by_cost_and_effect) {
+        operators.push_back(
+            RegressionOperator {entry.first.first, entry.second, entry.first.second});
+    }
+    return operators;
+}
+
+NodeID SymbolicPatternDatabase::regress(
+    NodeID states, const vector<RegressionOperator> &operators) {
+    /*
+      A state is a predecessor of states via an operator if it satisfies
+      the precondition and the result of applying the effect is in
+      states, i.e., if it is in the restriction of states to the effect.
+    */
+    NodeID predecessors = DDManager::FALSE_NODE;
+    for (const RegressionOperator &op : operators) {
+        NodeID op_predecessors = manager->apply_and(
+            op.precondition, manager->restrict(states, op.effect));
+        predecessors = manager->apply_or(predecessors, op_predecessors);
+    }
+    return predecessors;
+}
+
+void SymbolicPatternDatabase::compute_distances(
+    const TaskProxy &task_proxy, const vector<int> &operator_costs) {
+    NodeID valid_states = build_valid_states_bdd(task_proxy.get_variables());
+    map<int, vector<RegressionOperator>> operators_by_cost;
+    for (const RegressionOperator &op :
+         build_regression_operators(task_proxy, operator_costs)) {
+        operators_by_cost[op.cost].push_back(op);
+    }
+
+    vector<int> goal_assignment(manager->get_num_variables(), -1);
+    for (FactProxy goal : task_proxy.get_goals()) {
+        FactPair fact = goal.get_pair();
+        auto it = find(pattern.begin(), pattern.end(), fact.var);
+        if (it != pattern.end()) {
+            set_fact(it - pattern.begin(), fact.value, goal_assignment);
+        }
+    }
+
+    /*
+      Symbolic uniform-cost search: open maps g values to the BDDs of the
+      states reached with this cost, and each expanded layer contains the
+      states with goal distance g that were not reached before.
+    */
+    map<int, NodeID> open;
+    open[0] = manager->apply_and(
+        manager->make_cube(goal_assignment), valid_states);
+    NodeID reached = DDManager::FALSE_NODE;
+    vector<pair<int, NodeID>> layers;
+    int num_nodes_after_garbage_collection = manager->get_num_nodes();
+    while (!open.empty()) {
+        int g = open.begin()->first;
+        NodeID layer = manager->apply_and(
+            open.begin()->second, manager->negate(reached));
+        open.erase(open.begin());
+
+        auto zero_cost_operators = operators_by_cost.find(0);
+        if (zero_cost_operators != operators_by_cost.end()) {
+            NodeID frontier = layer;
+            while (frontier != DDManager::FALSE_NODE) {
+                NodeID new_states = manager->apply_and(
+                    regress(frontier, zero_cost_operators->second),
+                    valid_states);
+                new_states = manager->apply_and(
+                    new_states,
+                    manager->negate(manager->apply_or(reached, layer)));
+                layer = manager->apply_or(layer, new_states);
+                frontier = new_states;
+            }
+        }
+        if (layer == DDManager::FALSE_NODE) {
+            continue;
+        }
+        reached = manager->apply_or(reached, layer);
+        layers.emplace_back(g, layer);
+
+        for (const auto &entry : operators_by_cost) {
+            int cost = entry.first;
+            if (cost == 0) {
+                continue;
+            }
+            assert(g <= numeric_limits<int>::max() - cost);
+            NodeID predecessors = manager->apply_and(
+                regress(layer, entry.second), valid_states);
+            if (predecessors != DDManager::FALSE_NODE) {
+                NodeID &states = open.insert(
+                    make_pair(g + cost, DDManager::FALSE_NODE)).first->second;
+                states = manager->apply_or(states, predecessors);
+            }
+        }
+
+        if (manager->get_num_nodes() > 2 * num_nodes_after_garbage_collection) {
+            vector<NodeID *> roots = {&valid_states, &reached};
+            for (auto &entry : operators_by_cost) {
+                for (RegressionOperator &op : entry.second) {
+                    roots.push_back(&op.precondition);
+                    roots.push_back(&op.effect);
+                }
+            }
+            for (auto &entry : open) {
+                roots.push_back(&entry.second);
+            }
+            for (auto &entry : layers) {
+                roots.push_back(&entry.second);
+            }
+            manager->collect_garbage(roots);
+            num_nodes_after_garbage_collection = manager->get_num_nodes();
+        }
+    }
+
+    // The layers are disjoint, so we can combine them in any order.
+    distances = manager->get_terminal(numeric_limits<int>::max());
+    for (const auto &entry : layers) {
+        distances = manager->if_then_else(
+            entry.second, manager->get_terminal(entry.first), distances);
+    }
+    manager->collect_garbage({&distances});
+}
+
+int SymbolicPatternDatabase::get_num_nodes() const {
+    return manager->count_nodes(distances);
+}
+}
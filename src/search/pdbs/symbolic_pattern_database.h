@@ -0,0 +1,82 @@
+#ifndef PDBS_SYMBOLIC_PATTERN_DATABASE_H
+#define PDBS_SYMBOLIC_PATTERN_DATABASE_H
+
+#include "types.h"
+
+#include "../algorithms/decision_diagrams.h"
+#include "../task_proxy.h"
+
+#include <memory>
+#include <vector>
+
+namespace pdbs {
+/*
+  A pattern database that represents the goal distances of the abstract
+  states with a decision diagram instead of an explicit table, so its
+  size is not bounded by the number of abstract states.
+
+  Each pattern variable with domain size d is encoded by ceil(log2(d))
+  binary variables, most significant bit first, in the order of the
+  pattern. The distances are computed by a symbolic uniform-cost search
+  backwards from the abstract goal states, where each layer is the BDD
+  of the states with the same goal distance. The layers are then combined
+  into a single decision diagram that maps each abstract state to its
+  goal distance, or numeric_limits<int>::max() for dead ends, so a lookup
+  follows one path of at most as many nodes as there are binary variables.
+*/
+class SymbolicPatternDatabase {
+    struct RegressionOperator {
+        int cost;
+        decision_diagrams::NodeID precondition;
+        // Cube of the values that the operator assigns.
+        decision_diagrams::NodeID effect;
+    };
+
+    Pattern pattern;
+    // For each pattern variable, its first binary variable and bit count.
+    std::vector<int> first_binary_vars;
+    std::vector<int> num_bits;
+    // For each binary variable, the concrete variable and the bit it encodes.
+    std::vector<int> binary_var_to_var;
+    std::vector<int> binary_var_to_shift;
+
+    std::unique_ptr<decision_diagrams::DDManager> manager;
+    decision_diagrams::NodeID distances;
+
+    void set_fact(int pattern_index, int value, std::vector<int> &assignment) const;
+    decision_diagrams::NodeID build_valid_states_bdd(const VariablesProxy &variables);
+    std::vector<RegressionOperator> build_regression_operators(
+        const TaskProxy &task_proxy, const std::vector<int> &operator_costs);
+    decision_diagrams::NodeID regress(
+        decision_diagrams::NodeID states,
+        const std::vector<RegressionOperator> &operators);
+    void compute_distances(
+        const TaskProxy &task_proxy, const std::vector<int> &operator_costs);
+public:
+    /*
+      The pattern must be sorted and must not contain duplicates. If
+      operator_costs is empty, the costs of the task are used.
+    */
+    SymbolicPatternDatabase(
+        const TaskProxy &task_proxy,
+        const Pattern &pattern,
+        const std::vector<int> &operator_costs = std::vector<int>());
+
+    int get_value(const std::vector<int> &state) const {
+        return manager->evaluate(
+            distances, [&](int binary_var) {
+                return (state[binary_var_to_var[binary_var]] >>
+                        binary_var_to_shift[binary_var]) & 1;
+            });
+    }
+
+    const Pattern &get_pattern() const {
+        return pattern;
+    }
+
+    // Number of nodes of the decision diagram storing the distances.
+    int get_num_nodes() const;
+};
+}
+
+#endif
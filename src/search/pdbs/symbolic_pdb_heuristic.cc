@@ -0,0 +1,85 @@
+#include "symbolic_pdb_heuristic.h"
+
+#include "pattern_generator.h"
+#include "symbolic_pattern_database.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../utils/logging.h"
+#include "../utils/timer.h"
+
+#include <limits>
+#include <memory>
+
+using namespace std;
+
+namespace pdbs {
+static shared_ptr<SymbolicPatternDatabase> get_symbolic_pdb_from_options(
+    const shared_ptr<AbstractTask> &task, const Options &opts) {
+    shared_ptr<PatternGenerator> pattern_generator =
+        opts.get<shared_ptr<PatternGenerator>>("pattern");
+    PatternInformation pattern_info = pattern_generator->generate(task);
+    TaskProxy task_proxy(*task);
+    const Pattern &pattern = pattern_info.get_pattern();
+
+    utils::Timer timer;
+    shared_ptr<SymbolicPatternDatabase> pdb =
+        make_shared<SymbolicPatternDatabase>(task_proxy, pattern);
+    double num_abstract_states = 1;
+    for (int var : pattern) {
+        num_abstract_states *= task_proxy.get_variables()[var].get_domain_size();
+    }
+    utils::g_log << "Symbolic PDB abstract states: " << num_abstract_states << endl;
+    utils::g_log << "Symbolic PDB nodes: " << pdb->get_num_nodes() << endl;
+    utils::g_log << "Symbolic PDB construction time: " << timer << endl;
+    return pdb;
+}
+
+SymbolicPDBHeuristic::SymbolicPDBHeuristic(const Options &opts)
+    : Heuristic(opts),
+      pdb(get_symbolic_pdb_from_options(task, opts)) {
+}
+
+int SymbolicPDBHeuristic::compute_heuristic(const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    state.unpack();
+    int h = pdb->get_value(state.get_unpacked_values());
+    if (h == numeric_limits<int>::max())
+        return DEAD_END;
+    return h;
+}
+
+static shared_ptr<Heuristic> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Symbolic pattern database heuristic",
+        "Like the pattern database heuristic, but the goal distances of the "
+        "abstract states are computed by a symbolic backward search and "
+        "stored in a decision diagram instead of a table. This allows "
+        "patterns whose number of abstract states exceeds the limits of "
+        "explicit PDBs, as long as the decision diagram stays small. Use "
+        "manual_pattern to specify such patterns, since the greedy "
+        "pattern generator limits the number of abstract states.");
+    parser.document_language_support("action costs", "supported");
+    parser.document_language_support("conditional effects", "not supported");
+    parser.document_language_support("axioms", "not supported");
+    parser.document_property("admissible", "yes");
+    parser.document_property("consistent", "yes");
+    parser.document_property("safe", "yes");
+    parser.document_property("preferred operators", "no");
+
+    parser.add_option<shared_ptr<PatternGenerator>>(
+        "pattern",
+        "pattern generation method",
+        "greedy()");
+    Heuristic::add_options_to_parser(parser);
+
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+
+    return make_shared<SymbolicPDBHeuristic>(opts);
+}
+
+static Plugin<Evaluator> _plugin("symbolic_pdb", _parse, "heuristics_pdb");
+}
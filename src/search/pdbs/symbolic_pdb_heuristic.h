@@ -0,0 +1,24 @@
+#ifndef PDBS_SYMBOLIC_PDB_HEURISTIC_H
+#define PDBS_SYMBOLIC_PDB_HEURISTIC_H
+
+#include "../heuristic.h"
+
+namespace options {
+class Options;
+}
+
+namespace pdbs {
+class SymbolicPatternDatabase;
+
+// Implements a heuristic for a single symbolic PDB.
+class SymbolicPDBHeuristic : public Heuristic {
+    std::shared_ptr<SymbolicPatternDatabase> pdb;
+protected:
+    virtual int compute_heuristic(const State &ancestor_state) override;
+public:
+    explicit SymbolicPDBHeuristic(const options::Options &opts);
+    virtual ~SymbolicPDBHeuristic() override = default;
+};
+}
+
+#endif
@@ -10,6 +10,7 @@
 
 #include "../utils/logging.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 
 #include <limits>
@@ -42,6 +43,20 @@ int compute_total_pdb_size(
     return size;
 }
 
+PDBCollection compute_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    int num_threads, const shared_ptr<PDBCache> &pdb_cache) {
+    PDBCollection pdbs(patterns.size());
+    utils::parallel_for(
+        patterns.size(), num_threads,
+        [&](int i) {
+            pdbs[i] = make_shared<PatternDatabase>(
+                task_proxy, patterns[i], false, vector<int>(), false, nullptr,
+                false, pdb_cache);
+        });
+    return pdbs;
+}
+
 vector<FactPair> get_goals_in_random_order(
     const TaskProxy &task_proxy, utils::RandomNumberGenerator &rng) {
     vector<FactPair> goals = task_properties::get_fact_pairs(task_proxy.get_goals());
@@ -17,11 +17,21 @@ class RandomNumberGenerator;
 namespace pdbs {
 class PatternCollectionInformation;
 class PatternInformation;
+class PDBCache;
 
 extern int compute_pdb_size(const TaskProxy &task_proxy, const Pattern &pattern);
 extern int compute_total_pdb_size(
     const TaskProxy &task_proxy, const PatternCollection &pattern_collection);
 
+/*
+  Compute the PDBs for all given patterns, using up to num_threads threads.
+  The PDBs are in the same order as the patterns and do not depend on the
+  number of threads. If pdb_cache is given, it is used for all PDBs.
+*/
+extern PDBCollection compute_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    int num_threads, const std::shared_ptr<PDBCache> &pdb_cache = nullptr);
+
 extern std::vector<FactPair> get_goals_in_random_order(
     const TaskProxy &task_proxy, utils::RandomNumberGenerator &rng);
 extern std::vector<int> get_non_goal_variables(const TaskProxy &task_proxy);
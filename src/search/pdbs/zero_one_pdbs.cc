@@ -1,5 +1,7 @@
 #include "zero_one_pdbs.h"
 
+#include "distance_table.h"
+#include "packed_hash_plan.h"
 #include "pattern_database.h"
 
 #include "../task_proxy.h"
@@ -14,6 +16,23 @@
 using namespace std;
 
 namespace pdbs {
+/*
+  Add the values of one PDB to the sums in values, which start at index
+  first. Dead ends stay dead ends.
+*/
+static void add_pdb_values(
+    const vector<int> &pdb_values, size_t first, vector<int> &values) {
+    for (size_t i = 0; i < pdb_values.size(); ++i) {
+        int &h_val = values[first + i];
+        if (h_val == numeric_limits<int>::max())
+            continue;
+        if (pdb_values[i] == numeric_limits<int>::max())
+            h_val = numeric_limits<int>::max();
+        else
+            h_val += pdb_values[i];
+    }
+}
+
 ZeroOnePDBs::ZeroOnePDBs(
     const TaskProxy &task_proxy, const PatternCollection &patterns) {
     vector<int> remaining_operator_costs;
@@ -55,6 +74,52 @@ int ZeroOnePDBs::get_value(const State &state) const {
     return h_val;
 }
 
+void ZeroOnePDBs::get_values(
+    const vector<State> &states, vector<int> &values) const {
+    for (const State &state : states) {
+        state.unpack();
+    }
+    size_t first = values.size();
+    values.resize(first + states.size(), 0);
+    vector<int> pdb_values;
+    pdb_values.reserve(states.size());
+    for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
+        pdb_values.clear();
+        pdb->get_values(states, pdb_values);
+        add_pdb_values(pdb_values, first, values);
+    }
+}
+
+int ZeroOnePDBs::get_value(
+    const PackedHashPlan &plan, const State &state) const {
+    const PackedStateBin *buffer = state.get_buffer();
+    int h_val = 0;
+    for (size_t pdb_index = 0; pdb_index < pattern_databases.size(); ++pdb_index) {
+        int pdb_value = pattern_databases[pdb_index]->get_distances()[
+            plan.get_hash_index(pdb_index, buffer)];
+        if (pdb_value == numeric_limits<int>::max())
+            return numeric_limits<int>::max();
+        h_val += pdb_value;
+    }
+    return h_val;
+}
+
+void ZeroOnePDBs::get_values(
+    const PackedHashPlan &plan, const vector<State> &states,
+    vector<int> &values) const {
+    size_t first = values.size();
+    values.resize(first + states.size(), 0);
+    vector<int> pdb_values(states.size());
+    for (size_t pdb_index = 0; pdb_index < pattern_databases.size(); ++pdb_index) {
+        for (size_t i = 0; i < states.size(); ++i) {
+            pdb_values[i] = plan.get_hash_index(pdb_index, states[i].get_buffer());
+        }
+        pattern_databases[pdb_index]->get_distances().lookup(
+            pdb_values.data(), pdb_values.size());
+        add_pdb_values(pdb_values, first, values);
+    }
+}
+
 double ZeroOnePDBs::compute_approx_mean_finite_h() const {
     double approx_mean_finite_h = 0;
     for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
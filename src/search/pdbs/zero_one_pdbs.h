@@ -3,10 +3,14 @@
 
 #include "types.h"
 
+#include <vector>
+
 class State;
 class TaskProxy;
 
 namespace pdbs {
+class PackedHashPlan;
+
 class ZeroOnePDBs {
     PDBCollection pattern_databases;
 public:
@@ -14,6 +18,23 @@ public:
     ~ZeroOnePDBs() = default;
 
     int get_value(const State &state) const;
+    // Append the values of all given states to values (PDB by PDB).
+    void get_values(
+        const std::vector<State> &states, std::vector<int> &values) const;
+
+    /*
+      Like get_value and get_values above, but the states must be
+      registered and are read directly from their packed data with the
+      given plan, which must be built for the PDBs of this object.
+    */
+    int get_value(const PackedHashPlan &plan, const State &state) const;
+    void get_values(
+        const PackedHashPlan &plan, const std::vector<State> &states,
+        std::vector<int> &values) const;
+
+    const PDBCollection &get_pdbs() const {
+        return pattern_databases;
+    }
     /*
       Returns the sum of all mean finite h-values of every PDB.
       This is an approximation of the real mean finite h-value of the Heuristic,
@@ -5,6 +5,8 @@
 #include "../option_parser.h"
 #include "../plugin.h"
 
+#include "../utils/memory.h"
+
 #include <limits>
 
 using namespace std;
@@ -28,14 +30,60 @@ ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
       zero_one_pdbs(get_zero_one_pdbs_from_options(task, opts)) {
 }
 
+const PackedHashPlan &ZeroOnePDBsHeuristic::get_packed_hash_plan(
+    const int_packer::IntPacker &state_packer) {
+    if (!packed_hash_plan ||
+        &packed_hash_plan->get_state_packer() != &state_packer) {
+        packed_hash_plan = utils::make_unique_ptr<PackedHashPlan>(
+            zero_one_pdbs.get_pdbs(), state_packer);
+    }
+    return *packed_hash_plan;
+}
+
 int ZeroOnePDBsHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-    int h = zero_one_pdbs.get_value(state);
+    const int_packer::IntPacker *state_packer = get_state_packer(ancestor_state);
+    int h;
+    if (state_packer) {
+        h = zero_one_pdbs.get_value(
+            get_packed_hash_plan(*state_packer), ancestor_state);
+    } else {
+        State state = convert_ancestor_state(ancestor_state);
+        h = zero_one_pdbs.get_value(state);
+    }
     if (h == numeric_limits<int>::max())
         return DEAD_END;
     return h;
 }
 
+void ZeroOnePDBsHeuristic::compute_results(vector<StateEvaluationContext> &batch) {
+    compute_batch_results(batch);
+}
+
+bool ZeroOnePDBsHeuristic::supports_batch_evaluation() const {
+    return true;
+}
+
+void ZeroOnePDBsHeuristic::compute_heuristics(
+    const vector<State> &ancestor_states, vector<int> &heuristics) {
+    size_t first = heuristics.size();
+    const int_packer::IntPacker *state_packer = get_state_packer(ancestor_states);
+    if (state_packer) {
+        zero_one_pdbs.get_values(
+            get_packed_hash_plan(*state_packer), ancestor_states, heuristics);
+    } else {
+        vector<State> states;
+        states.reserve(ancestor_states.size());
+        for (const State &ancestor_state : ancestor_states) {
+            states.push_back(convert_ancestor_state(ancestor_state));
+        }
+        zero_one_pdbs.get_values(states, heuristics);
+    }
+    for (size_t i = first; i < heuristics.size(); ++i) {
+        if (heuristics[i] == numeric_limits<int>::max())
+            heuristics[i] = DEAD_END;
+    }
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Zero-One PDB",
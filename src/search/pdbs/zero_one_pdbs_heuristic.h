@@ -1,6 +1,7 @@
 #ifndef PDBS_ZERO_ONE_PDBS_HEURISTIC_H
 #define PDBS_ZERO_ONE_PDBS_HEURISTIC_H
 
+#include "packed_hash_plan.h"
 #include "zero_one_pdbs.h"
 
 #include "../heuristic.h"
@@ -10,11 +11,23 @@ class PatternDatabase;
 
 class ZeroOnePDBsHeuristic : public Heuristic {
     ZeroOnePDBs zero_one_pdbs;
+    // Used for looking up registered states without unpacking them.
+    std::unique_ptr<PackedHashPlan> packed_hash_plan;
+
+    const PackedHashPlan &get_packed_hash_plan(
+        const int_packer::IntPacker &state_packer);
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
+    virtual void compute_heuristics(
+        const std::vector<State> &ancestor_states,
+        std::vector<int> &heuristics) override;
 public:
     ZeroOnePDBsHeuristic(const options::Options &opts);
     virtual ~ZeroOnePDBsHeuristic() = default;
+
+    virtual void compute_results(
+        std::vector<StateEvaluationContext> &batch) override;
+    virtual bool supports_batch_evaluation() const override;
 };
 }
 
@@ -110,7 +110,7 @@ public:
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
         segmented_vector::SegmentedArrayVector<Element> *entries = get_entries(registry);
-        int state_id = state.get_id().value;
+        StateID::ValueType state_id = state.get_id().value;
         assert(state.get_id() != StateID::no_state);
         size_t virtual_size = registry->size();
         assert(utils::in_bounds(state_id, *registry));
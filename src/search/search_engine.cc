@@ -10,6 +10,7 @@
 #include "task_utils/task_properties.h"
 #include "tasks/root_task.h"
 #include "utils/countdown_timer.h"
+#include "utils/file_backed_arena.h"
 #include "utils/logging.h"
 #include "utils/rng_options.h"
 #include "utils/system.h"
@@ -18,6 +19,7 @@
 #include <cassert>
 #include <iostream>
 #include <limits>
+#include <memory>
 
 using namespace std;
 using utils::ExitCode;
@@ -41,12 +43,21 @@ successor_generator::SuccessorGenerator &get_successor_generator(const TaskProxy
     return successor_generator;
 }
 
+shared_ptr<utils::FileBackedArena> create_state_data_arena(
+    const Options &opts) {
+    if (opts.get<StateStorage>("state_storage") == StateStorage::DISK) {
+        return make_shared<utils::FileBackedArena>(
+            opts.get<string>("state_storage_directory"));
+    }
+    return nullptr;
+}
+
 SearchEngine::SearchEngine(const Options &opts)
     : status(IN_PROGRESS),
       solution_found(false),
       task(tasks::g_root_task),
       task_proxy(*task),
-      state_registry(task_proxy),
+      state_registry(task_proxy, create_state_data_arena(opts)),
       successor_generator(get_successor_generator(task_proxy)),
       search_space(state_registry),
       search_progress(opts.get<utils::Verbosity>("verbosity")),
@@ -157,6 +168,31 @@ void SearchEngine::add_options_to_parser(OptionParser &parser) {
         "experiments. Timed-out searches are treated as failed searches, "
         "just like incomplete search algorithms that exhaust their search space.",
         "infinity");
+    vector<string> state_storage_names;
+    vector<string> state_storage_docs;
+    state_storage_names.push_back("ram");
+    state_storage_docs.push_back(
+        "keep all registered states in main memory");
+    state_storage_names.push_back("disk");
+    state_storage_docs.push_back(
+        "store registered states in memory that is backed by a temporary "
+        "file in state_storage_directory. The operating system pages states "
+        "that are not accessed for a while out to the file, so the search "
+        "can store more states than fit into main memory. Only the packed "
+        "states are stored on disk; the duplicate-detection hash set and "
+        "per-state information (search nodes, cached heuristic values) "
+        "remain in main memory. Not supported on Windows.");
+    parser.add_enum_option<StateStorage>(
+        "state_storage",
+        state_storage_names,
+        "where to store the registered states",
+        "ram",
+        state_storage_docs);
+    parser.add_option<string>(
+        "state_storage_directory",
+        "directory for the temporary file used with state_storage=disk. "
+        "It should be on a local disk with enough free space.",
+        ".");
     utils::add_verbosity_option_to_parser(parser);
 }
 
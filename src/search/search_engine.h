@@ -35,6 +35,9 @@ enum class Verbosity;
 
 enum SearchStatus {IN_PROGRESS, TIMEOUT, FAILED, SOLVED};
 
+// Where the state registry of a search engine stores the packed states.
+enum class StateStorage {RAM, DISK};
+
 class SearchEngine {
     SearchStatus status;
     bool solution_found;
@@ -83,6 +86,14 @@ public:
     static void add_succ_order_options(options::OptionParser &parser);
 };
 
+/*
+  Create the arena for the packed states of a state registry selected by
+  the options state_storage and state_storage_directory. Return nullptr
+  if the states are stored in RAM.
+*/
+extern std::shared_ptr<utils::FileBackedArena> create_state_data_arena(
+    const options::Options &opts);
+
 /*
   Print evaluator values of all evaluators evaluated in the evaluation context.
 */
@@ -9,10 +9,12 @@
 #include "../algorithms/ordered_set.h"
 #include "../evaluators/g_evaluator.h"
 #include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
 #include "../tasks/cost_adapted_task.h"
 
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <memory>
@@ -31,7 +33,9 @@ EagerSearch::EagerSearch(const Options &opts)
       f_evaluator(opts.get<shared_ptr<Evaluator>>("f_evaluator", nullptr)),
       preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
       lazy_evaluator(opts.get<shared_ptr<Evaluator>>("lazy_evaluator", nullptr)),
-      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")) {
+      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      duplicate_detection_batch_size(
+          opts.get<int>("delayed_duplicate_detection")) {
     if (reopen_closed_nodes && !g_evaluator) {
         cerr << "g_evaluator is required if reopen_closed=true. "
              << "For example, you may use g_evaluator=g()." << endl;
@@ -45,6 +49,9 @@ EagerSearch::EagerSearch(const Options &opts)
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
     }
+    if (duplicate_detection_batch_size > 0) {
+        task_properties::verify_no_axioms(task_proxy);
+    }
 }
 
 void EagerSearch::initialize() {
@@ -52,6 +59,10 @@ void EagerSearch::initialize() {
                  << (reopen_closed_nodes ? " with" : " without")
                  << " reopening closed nodes, (real) bound = " << bound
                  << endl;
+    if (duplicate_detection_batch_size > 0) {
+        utils::g_log << "Using delayed duplicate detection with batches of "
+                     << duplicate_detection_batch_size << " successors" << endl;
+    }
     assert(open_list);
 
     set<Evaluator *> evals;
@@ -90,6 +101,14 @@ void EagerSearch::initialize() {
 
     path_dependent_evaluators.assign(evals.begin(), evals.end());
 
+    set<Evaluator *> open_list_evaluators;
+    open_list->get_evaluators(open_list_evaluators);
+    for (Evaluator *evaluator : open_list_evaluators) {
+        if (evaluator->supports_batch_evaluation()) {
+            batch_evaluators.push_back(evaluator);
+        }
+    }
+
     State initial_state = state_registry.get_initial_state();
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
@@ -131,6 +150,10 @@ SearchStatus EagerSearch::step() {
     tl::optional<SearchNode> node;
     while (true) {
         if (open_list->empty()) {
+            if (!pending_successors.empty()) {
+                flush_pending_successors();
+                continue;
+            }
             utils::g_log << "Completely explored state space -- no solution!" << endl;
             return FAILED;
         }
@@ -180,6 +203,22 @@ SearchStatus EagerSearch::step() {
             }
         }
 
+        if (!pending_successors.empty() &&
+            task_properties::is_goal_state(task_proxy, s)) {
+            /*
+              A pending successor might lead to a cheaper goal, so we
+              register the pending successors and consider the goal again
+              afterwards. If they reach the goal on a cheaper path and we
+              reopen nodes, they have already put it back into the open
+              list. Otherwise we put it back ourselves, so that the open
+              list contains it exactly once.
+            */
+            if (!flush_pending_successors(id)) {
+                open_list->insert(eval_context, id);
+            }
+            continue;
+        }
+
         node->close();
         assert(!node->is_dead_end());
         update_f_value_statistics(eval_context);
@@ -216,90 +255,220 @@ SearchStatus EagerSearch::step() {
         if (real_g_evaluator && node_real_g + op.get_cost() >= bound)
             continue;
 
-        State succ_state = state_registry.get_successor_state(s, op);
-        statistics.inc_generated();
         bool is_preferred = preferred_operators.contains(op_id);
+        if (duplicate_detection_batch_size > 0) {
+            delay_successor(*node, op, is_preferred);
+        } else if (batch_evaluators.empty()) {
+            State succ_state = state_registry.get_successor_state(s, op);
+            statistics.inc_generated();
+            insert_successor(*node, op, succ_state, is_preferred);
+        } else {
+            successors.emplace_back(
+                state_registry.get_successor_state(s, op), op_id, is_preferred);
+            statistics.inc_generated();
+        }
+    }
+    if (!successors.empty()) {
+        insert_successors(*node);
+    }
+
+    if (duplicate_detection_batch_size > 0 &&
+        pending_successors.size() >=
+        static_cast<size_t>(duplicate_detection_batch_size)) {
+        flush_pending_successors();
+    }
+
+    return IN_PROGRESS;
+}
+
+void EagerSearch::notify_state_transition(
+    const SearchNode &node, const OperatorProxy &op, const State &succ_state) {
+    for (Evaluator *evaluator : path_dependent_evaluators) {
+        evaluator->notify_state_transition(
+            node.get_state(), OperatorID(op.get_id()), succ_state);
+    }
+}
 
-        for (Evaluator *evaluator : path_dependent_evaluators) {
-            evaluator->notify_state_transition(s, op_id, succ_state);
+bool EagerSearch::insert_successor(
+    const SearchNode &node, const OperatorProxy &op,
+    const State &succ_state, bool is_preferred) {
+    notify_state_transition(node, op, succ_state);
+    StateEvaluationContext succ_eval_context(succ_state.get_id(), state_registry,
+                                             is_preferred, &statistics);
+    return insert_successor(node, op, succ_eval_context);
+}
+
+void EagerSearch::insert_successors(const SearchNode &node) {
+    /*
+      Path-dependent evaluators must see the transitions into a state in
+      the order in which we insert them. We can only notify them of all
+      transitions up front if no state is reached twice.
+    */
+    successor_ids.clear();
+    for (const Successor &succ : successors) {
+        successor_ids.push_back(succ.state.get_id());
+    }
+    sort(successor_ids.begin(), successor_ids.end());
+    bool has_duplicates = adjacent_find(
+        successor_ids.begin(), successor_ids.end()) != successor_ids.end();
+    OperatorsProxy operators = task_proxy.get_operators();
+
+    if (has_duplicates) {
+        for (const Successor &succ : successors) {
+            insert_successor(
+                node, operators[succ.op_id], succ.state, succ.is_preferred);
         }
-        StateEvaluationContext succ_eval_context(succ_state.get_id(), state_registry,
-                                                 is_preferred, &statistics);
+        successors.clear();
+        return;
+    }
 
-        SearchNode succ_node = search_space.get_node(succ_state);
+    for (const Successor &succ : successors) {
+        notify_state_transition(node, operators[succ.op_id], succ.state);
+    }
 
-        // Previously encountered dead end. Don't re-evaluate.
-        if (succ_node.is_dead_end())
-            continue;
+    // Only new states are evaluated, so only they form the batch.
+    batch.clear();
+    batch_indices.clear();
+    for (const Successor &succ : successors) {
+        if (search_space.get_node(succ.state).is_new()) {
+            batch_indices.push_back(batch.size());
+            batch.emplace_back(succ.state.get_id(), state_registry,
+                               succ.is_preferred, &statistics);
+        } else {
+            batch_indices.push_back(-1);
+        }
+    }
+    if (!batch.empty()) {
+        for (Evaluator *evaluator : batch_evaluators) {
+            evaluator->compute_results(batch);
+        }
+    }
 
-        if (succ_node.is_new()) {
-            // We have not seen this state before.
-            // Evaluate and create a new node.
+    for (size_t i = 0; i < successors.size(); ++i) {
+        const Successor &succ = successors[i];
+        OperatorProxy op = operators[succ.op_id];
+        if (batch_indices[i] == -1) {
+            StateEvaluationContext succ_eval_context(
+                succ.state.get_id(), state_registry, succ.is_preferred,
+                &statistics);
+            insert_successor(node, op, succ_eval_context);
+        } else {
+            insert_successor(node, op, batch[batch_indices[i]]);
+        }
+    }
+    successors.clear();
+    batch.clear();
+}
 
-            statistics.inc_evaluated_states();
-            if (open_list->is_dead_end(succ_eval_context)) {
-                succ_node.mark_as_dead_end();
-                statistics.inc_dead_ends();
-                continue;
-            }
-            succ_node.open(*node, op);
+bool EagerSearch::insert_successor(
+    const SearchNode &node, const OperatorProxy &op,
+    StateEvaluationContext &succ_eval_context) {
+    const State &succ_state = succ_eval_context.get_state();
+    SearchNode succ_node = search_space.get_node(succ_state);
+
+    // Previously encountered dead end. Don't re-evaluate.
+    if (succ_node.is_dead_end())
+        return false;
+
+    if (succ_node.is_new()) {
+        // We have not seen this state before.
+        // Evaluate and create a new node.
+
+        statistics.inc_evaluated_states();
+        if (open_list->is_dead_end(succ_eval_context)) {
+            succ_node.mark_as_dead_end();
+            statistics.inc_dead_ends();
+            return false;
+        }
+        succ_node.open(node, op);
+
+        open_list->insert(succ_eval_context, succ_state.get_id());
+        if (search_progress.check_progress(succ_eval_context)) {
+            int succ_g_new = g_evaluator
+                ? g_evaluator->get_cached_estimate(succ_state)
+                : -1;
+            statistics.print_checkpoint_line(succ_g_new);
+            reward_progress();
+        }
+        return true;
+    } else if (g_evaluator && g_evaluator->is_cached_estimate_dirty(succ_state)) {
+        // We found a new cheapest path to an open or closed state.
 
-            open_list->insert(succ_eval_context, succ_state.get_id());
-            if (search_progress.check_progress(succ_eval_context)) {
-                int succ_g_new = g_evaluator
-                    ? g_evaluator->get_cached_estimate(succ_state)
-                    : -1;
-                statistics.print_checkpoint_line(succ_g_new);
-                reward_progress();
-            }
-        } else if (g_evaluator && g_evaluator->is_cached_estimate_dirty(succ_state)) {
-            // We found a new cheapest path to an open or closed state.
-
-            // Mark cached g-value as not dirty.
-            succ_eval_context.get_evaluator_value(g_evaluator.get());
-            assert(!g_evaluator->is_cached_estimate_dirty(succ_state));
-
-            if (reopen_closed_nodes) {
-                if (succ_node.is_closed()) {
-                    /*
-                      TODO: It would be nice if we had a way to test
-                      that reopening is expected behaviour, i.e., exit
-                      with an error when this is something where
-                      reopening should not occur (e.g. A* with a
-                      consistent heuristic).
-                    */
-                    statistics.inc_reopened();
-                }
-                succ_node.reopen(*node, op);
+        // Mark cached g-value as not dirty.
+        succ_eval_context.get_evaluator_value(g_evaluator.get());
+        assert(!g_evaluator->is_cached_estimate_dirty(succ_state));
 
+        if (reopen_closed_nodes) {
+            if (succ_node.is_closed()) {
                 /*
-                  Note: our old code used to retrieve the h value from
-                  the search node here. Our new code recomputes it as
-                  necessary, thus avoiding the incredible ugliness of
-                  the old "set_evaluator_value" approach, which also
-                  did not generalize properly to settings with more
-                  than one evaluator.
-
-                  Reopening should not happen all that frequently, so
-                  the performance impact of this is hopefully not that
-                  large. In the medium term, we want the evaluators to
-                  remember evaluator values for states themselves if
-                  desired by the user, so that such recomputations
-                  will just involve a look-up by the Evaluator object
-                  rather than a recomputation of the evaluator value
-                  from scratch.
+                  TODO: It would be nice if we had a way to test
+                  that reopening is expected behaviour, i.e., exit
+                  with an error when this is something where
+                  reopening should not occur (e.g. A* with a
+                  consistent heuristic).
                 */
-                open_list->insert(succ_eval_context, succ_state.get_id());
-            } else {
-                // If we do not reopen closed nodes, we just update the parent pointers.
-                // Note that this could cause an incompatibility between
-                // the g-value and the actual path that is traced back.
-                succ_node.update_parent(*node, op);
+                statistics.inc_reopened();
             }
+            succ_node.reopen(node, op);
+
+            /*
+              Note: our old code used to retrieve the h value from
+              the search node here. Our new code recomputes it as
+              necessary, thus avoiding the incredible ugliness of
+              the old "set_evaluator_value" approach, which also
+              did not generalize properly to settings with more
+              than one evaluator.
+
+              Reopening should not happen all that frequently, so
+              the performance impact of this is hopefully not that
+              large. In the medium term, we want the evaluators to
+              remember evaluator values for states themselves if
+              desired by the user, so that such recomputations
+              will just involve a look-up by the Evaluator object
+              rather than a recomputation of the evaluator value
+              from scratch.
+            */
+            open_list->insert(succ_eval_context, succ_state.get_id());
+            return true;
+        } else {
+            // If we do not reopen closed nodes, we just update the parent pointers.
+            // Note that this could cause an incompatibility between
+            // the g-value and the actual path that is traced back.
+            succ_node.update_parent(node, op);
         }
     }
+    return false;
+}
 
-    return IN_PROGRESS;
+void EagerSearch::delay_successor(
+    const SearchNode &node, const OperatorProxy &op, bool is_preferred) {
+    int num_bins = state_registry.get_bins_per_state();
+    int data_index = pending_successor_data.size();
+    pending_successor_data.resize(data_index + num_bins);
+    PackedStateBin *buffer = &pending_successor_data[data_index];
+    state_registry.compute_successor_data(node.get_state(), op, buffer);
+    pending_successors.emplace_back(
+        node.get_state().get_id(), OperatorID(op.get_id()), is_preferred,
+        data_index);
+    statistics.inc_generated();
+}
+
+bool EagerSearch::flush_pending_successors(StateID watched_id) {
+    bool inserted_watched_state = false;
+    for (const PendingSuccessor &pending : pending_successors) {
+        State succ_state = state_registry.register_state_data(
+            &pending_successor_data[pending.data_index]);
+        State parent = state_registry.lookup_state(pending.parent_id);
+        SearchNode node = search_space.get_node(parent);
+        OperatorProxy op = task_proxy.get_operators()[pending.op_id];
+        if (insert_successor(node, op, succ_state, pending.is_preferred) &&
+            succ_state.get_id() == watched_id) {
+            inserted_watched_state = true;
+        }
+    }
+    pending_successors.clear();
+    pending_successor_data.clear();
+    return inserted_watched_state;
 }
 
 void EagerSearch::reward_progress() {
@@ -329,6 +498,15 @@ void EagerSearch::update_f_value_statistics(StateEvaluationContext &eval_context
 }
 
 void add_options_to_parser(OptionParser &parser) {
+    parser.add_option<int>(
+        "delayed_duplicate_detection",
+        "if positive, register generated successors in batches of (at least) "
+        "this size instead of one at a time. This is useful in combination "
+        "with state_storage=disk. Since successors enter the open list later, "
+        "more nodes may have to be reopened. Not supported for tasks with "
+        "axioms.",
+        "0",
+        Bounds("0", "infinity"));
     SearchEngine::add_pruning_option(parser);
     SearchEngine::add_options_to_parser(parser);
 }
@@ -29,6 +29,69 @@ class EagerSearch : public SearchEngine {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
+    /*
+      Evaluators used by the open list that support batch evaluation. If
+      there are any, we let them evaluate all new successors of an
+      expanded state as one batch (see Evaluator::compute_results) before
+      inserting the successors. Otherwise, we insert each successor as
+      soon as it is generated.
+    */
+    std::vector<Evaluator *> batch_evaluators;
+    struct Successor {
+        State state;
+        OperatorID op_id;
+        bool is_preferred;
+
+        Successor(const State &state, OperatorID op_id, bool is_preferred)
+            : state(state), op_id(op_id), is_preferred(is_preferred) {
+        }
+    };
+    std::vector<Successor> successors;
+    // Reused by insert_successors.
+    std::vector<StateID> successor_ids;
+    std::vector<StateEvaluationContext> batch;
+    std::vector<int> batch_indices;
+
+    /*
+      With delayed duplicate detection, successors are not registered when
+      they are generated. Instead, we collect their packed data and register
+      the whole batch at once, in generation order, once the batch is full,
+      the open list runs empty or a goal state is about to be expanded.
+    */
+    struct PendingSuccessor {
+        StateID parent_id;
+        OperatorID op_id;
+        bool is_preferred;
+        int data_index;
+
+        PendingSuccessor(StateID parent_id, OperatorID op_id,
+                         bool is_preferred, int data_index)
+            : parent_id(parent_id), op_id(op_id), is_preferred(is_preferred),
+              data_index(data_index) {
+        }
+    };
+    const int duplicate_detection_batch_size;
+    std::vector<PendingSuccessor> pending_successors;
+    std::vector<PackedStateBin> pending_successor_data;
+
+    void notify_state_transition(
+        const SearchNode &node, const OperatorProxy &op, const State &succ_state);
+    // Return true if the successor was inserted into the open list.
+    bool insert_successor(
+        const SearchNode &node, const OperatorProxy &op,
+        const State &succ_state, bool is_preferred);
+    bool insert_successor(
+        const SearchNode &node, const OperatorProxy &op,
+        StateEvaluationContext &succ_eval_context);
+    void insert_successors(const SearchNode &node);
+    void delay_successor(
+        const SearchNode &node, const OperatorProxy &op, bool is_preferred);
+    /*
+      Register the pending successors and insert them into the open list.
+      Return true if this inserted the state with the given ID.
+    */
+    bool flush_pending_successors(StateID watched_id = StateID::no_state);
+
     void start_f_value_statistics(StateEvaluationContext &eval_context);
     void update_f_value_statistics(StateEvaluationContext &eval_context);
     void reward_progress();
@@ -0,0 +1,691 @@
+#include "parallel_astar_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../option_parser.h"
+#include "../option_parser_util.h"
+#include "../per_state_information.h"
+#include "../plugin.h"
+
+#include "../task_utils/successor_generator.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/file_backed_arena.h"
+#include "../utils/logging.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace parallel_astar_search {
+static const int INF = numeric_limits<int>::max();
+
+/*
+  Number of loop iterations after which a worker checks the time limit.
+  Checking the clock on every expansion is surprisingly expensive.
+*/
+static const int TIME_CHECK_INTERVAL = 1000;
+
+struct ParallelSearchNode {
+    // g == -1 means that the node is new. h == INF marks dead ends.
+    int g;
+    int h;
+    bool closed;
+    /* Parents can live in other shards, so we store the shard of the parent
+       together with its ID in that shard's registry. */
+    int parent_shard;
+    StateID parent_id;
+    OperatorID creating_operator;
+
+    ParallelSearchNode()
+        : g(-1),
+          h(-1),
+          closed(false),
+          parent_shard(-1),
+          parent_id(StateID::no_state),
+          creating_operator(OperatorID::no_operator) {
+    }
+};
+
+struct GeneratedState {
+    int g;
+    int parent_shard;
+    StateID parent_id;
+    OperatorID creating_operator;
+};
+
+/*
+  Generated states owned by another shard. The packed data of the i-th
+  state is stored at position i * bins_per_state of state_data.
+*/
+struct MessageBatch {
+    vector<GeneratedState> states;
+    vector<PackedStateBin> state_data;
+    /* Lowest f-value of the parents of the states. For consistent
+       heuristics, this is a lower bound on the f-values of the states. */
+    int min_parent_f;
+
+    MessageBatch()
+        : min_parent_f(INF) {
+    }
+
+    bool empty() const {
+        return states.empty();
+    }
+
+    void clear() {
+        states.clear();
+        state_data.clear();
+        min_parent_f = INF;
+    }
+};
+
+struct OpenListEntry {
+    int f;
+    int h;
+    int g;
+    StateID id;
+
+    // Order by f and break ties in favor of lower h.
+    bool operator>(const OpenListEntry &other) const {
+        return f > other.f || (f == other.f && h > other.h);
+    }
+};
+
+
+/*
+  Copy of the statistics of a worker that other threads may read while
+  the worker runs.
+*/
+struct PublishedStatistics {
+    atomic<int> expanded;
+    atomic<int> evaluated_states;
+    atomic<int> evaluations;
+    atomic<int> generated;
+    atomic<int> reopened;
+    atomic<int> generated_ops;
+    atomic<int> dead_ends;
+
+    PublishedStatistics()
+        : expanded(0),
+          evaluated_states(0),
+          evaluations(0),
+          generated(0),
+          reopened(0),
+          generated_ops(0),
+          dead_ends(0) {
+    }
+};
+
+
+class ParallelAStarSearch::Worker {
+    ParallelAStarSearch &engine;
+    const int id;
+    const shared_ptr<Evaluator> evaluator;
+    StateRegistry registry;
+    const int bins_per_state;
+    PerStateInformation<ParallelSearchNode> search_nodes;
+    SearchStatistics statistics;
+    PublishedStatistics published_statistics;
+    /* f-value of the next node to expand, or INF if there is none, and
+       lowest parent f-value of the messages that were delivered since
+       next_f_value was last published. Together, they let other threads
+       estimate the lowest f-value that this worker still has to expand. */
+    atomic<int> next_f_value;
+    atomic<int> pending_f_value;
+    priority_queue<OpenListEntry, vector<OpenListEntry>, greater<OpenListEntry>> open_list;
+
+    mutex inbox_mutex;
+    MessageBatch inbox;
+    // Only accessed by the worker thread itself.
+    MessageBatch received;
+    vector<MessageBatch> outboxes;
+
+    vector<PackedStateBin> successor_data;
+    vector<OperatorID> applicable_ops;
+
+    void receive(const PackedStateBin *buffer, const GeneratedState &generated);
+    void send(int owner, const PackedStateBin *buffer,
+              const GeneratedState &generated, int parent_f);
+public:
+    Worker(ParallelAStarSearch &engine, int id,
+           const shared_ptr<Evaluator> &evaluator,
+           const shared_ptr<utils::FileBackedArena> &state_data_arena);
+
+    StateID insert_initial_state(const State &initial_state);
+    bool process_messages();
+    bool expand_next_node();
+    void flush_outboxes();
+    void deliver(MessageBatch &batch);
+    void publish_progress();
+
+    bool is_dead_end(StateID state_id) const;
+    const ParallelSearchNode &get_node(StateID state_id) const;
+    StateEvaluationContext evaluate(StateID state_id);
+
+    const StateRegistry &get_registry() const {
+        return registry;
+    }
+
+    const SearchStatistics &get_statistics() const {
+        return statistics;
+    }
+
+    const PublishedStatistics &get_published_statistics() const {
+        return published_statistics;
+    }
+
+    int get_next_f_value() const {
+        return min(next_f_value.load(memory_order_relaxed),
+                   pending_f_value.load(memory_order_relaxed));
+    }
+};
+
+ParallelAStarSearch::Worker::Worker(
+    ParallelAStarSearch &engine, int id,
+    const shared_ptr<Evaluator> &evaluator,
+    const shared_ptr<utils::FileBackedArena> &state_data_arena)
+    : engine(engine),
+      id(id),
+      evaluator(evaluator),
+      registry(engine.task_proxy, state_data_arena),
+      bins_per_state(registry.get_bins_per_state()),
+      statistics(engine.verbosity),
+      next_f_value(INF),
+      pending_f_value(INF),
+      outboxes(engine.num_threads),
+      successor_data(bins_per_state) {
+}
+
+void ParallelAStarSearch::Worker::receive(
+    const PackedStateBin *buffer, const GeneratedState &generated) {
+    State state = registry.register_state_data(buffer);
+    ParallelSearchNode &node = search_nodes[state];
+    if (node.g == -1) {
+        StateEvaluationContext eval_context(state.get_id(), registry, &statistics);
+        statistics.inc_evaluated_states();
+        node.h = eval_context.get_evaluator_value_or_infinity(evaluator.get());
+        if (node.h == EvaluationResult::INFTY) {
+            node.g = generated.g;
+            node.h = INF;
+            statistics.inc_dead_ends();
+            return;
+        }
+    } else if (node.h == INF || generated.g >= node.g) {
+        return;
+    } else if (node.closed) {
+        /*
+          Unlike in sequential A*, a worker can close a node before a
+          cheaper path to it has been found by another worker, even with
+          a consistent heuristic.
+        */
+        node.closed = false;
+        statistics.inc_reopened();
+    }
+    node.g = generated.g;
+    node.parent_shard = generated.parent_shard;
+    node.parent_id = generated.parent_id;
+    node.creating_operator = generated.creating_operator;
+    open_list.push({node.g + node.h, node.h, node.g, state.get_id()});
+}
+
+void ParallelAStarSearch::Worker::send(
+    int owner, const PackedStateBin *buffer, const GeneratedState &generated,
+    int parent_f) {
+    if (owner == id) {
+        receive(buffer, generated);
+    } else {
+        MessageBatch &outbox = outboxes[owner];
+        outbox.min_parent_f = min(outbox.min_parent_f, parent_f);
+        outbox.states.push_back(generated);
+        outbox.state_data.insert(
+            outbox.state_data.end(), buffer, buffer + bins_per_state);
+    }
+}
+
+StateID ParallelAStarSearch::Worker::insert_initial_state(
+    const State &initial_state) {
+    GeneratedState generated = {
+        0, -1, StateID::no_state, OperatorID::no_operator};
+    receive(initial_state.get_buffer(), generated);
+    return registry.register_state_data(initial_state.get_buffer()).get_id();
+}
+
+void ParallelAStarSearch::Worker::deliver(MessageBatch &batch) {
+    lock_guard<mutex> lock(inbox_mutex);
+    inbox.min_parent_f = min(inbox.min_parent_f, batch.min_parent_f);
+    pending_f_value.store(
+        min(pending_f_value.load(memory_order_relaxed), batch.min_parent_f),
+        memory_order_relaxed);
+    inbox.states.insert(inbox.states.end(),
+                        batch.states.begin(), batch.states.end());
+    inbox.state_data.insert(inbox.state_data.end(),
+                            batch.state_data.begin(), batch.state_data.end());
+}
+
+bool ParallelAStarSearch::Worker::process_messages() {
+    {
+        lock_guard<mutex> lock(inbox_mutex);
+        if (inbox.empty())
+            return false;
+        swap(inbox, received);
+    }
+    /*
+      Mark the worker as busy before the messages stop counting as
+      unprocessed. Otherwise, another worker could detect termination
+      while we still add nodes to our open list.
+    */
+    engine.idle[id] = false;
+    int num_messages = received.states.size();
+    for (int i = 0; i < num_messages; ++i) {
+        receive(&received.state_data[i * bins_per_state], received.states[i]);
+    }
+    received.clear();
+    engine.num_unprocessed_messages -= num_messages;
+    return true;
+}
+
+void ParallelAStarSearch::Worker::flush_outboxes() {
+    for (int owner = 0; owner < engine.num_threads; ++owner) {
+        MessageBatch &outbox = outboxes[owner];
+        if (!outbox.empty()) {
+            int num_messages = outbox.states.size();
+            engine.num_sent_messages += num_messages;
+            engine.num_unprocessed_messages += num_messages;
+            engine.workers[owner]->deliver(outbox);
+            outbox.clear();
+        }
+    }
+}
+
+bool ParallelAStarSearch::Worker::expand_next_node() {
+    while (!open_list.empty()) {
+        OpenListEntry entry = open_list.top();
+        if (entry.f >= engine.incumbent_cost)
+            return false;
+        open_list.pop();
+
+        State state = registry.lookup_state(entry.id);
+        ParallelSearchNode &node = search_nodes[state];
+        if (node.closed || entry.g != node.g)
+            continue;
+        node.closed = true;
+        statistics.inc_expanded();
+
+        if (task_properties::is_goal_state(engine.task_proxy, state)) {
+            engine.report_solution(id, state.get_id(), node.g);
+            return true;
+        }
+
+        applicable_ops.clear();
+        engine.successor_generator.generate_applicable_ops(state, applicable_ops);
+        statistics.inc_generated_ops(applicable_ops.size());
+        for (OperatorID op_id : applicable_ops) {
+            OperatorProxy op = engine.task_proxy.get_operators()[op_id];
+            int succ_g = node.g + op.get_cost();
+            if (succ_g >= engine.bound)
+                continue;
+            registry.compute_successor_data(state, op, successor_data.data());
+            statistics.inc_generated();
+            GeneratedState generated = {succ_g, id, state.get_id(), op_id};
+            send(engine.get_owner(successor_data.data()),
+                 successor_data.data(), generated, entry.f);
+        }
+        return true;
+    }
+    return false;
+}
+
+void ParallelAStarSearch::Worker::publish_progress() {
+    int next_f = INF;
+    if (!open_list.empty() && open_list.top().f < engine.incumbent_cost)
+        next_f = open_list.top().f;
+    next_f_value.store(next_f, memory_order_relaxed);
+    {
+        /*
+          The received messages are in the open list now. Only the
+          messages that arrived after we swapped the inbox are pending.
+        */
+        lock_guard<mutex> lock(inbox_mutex);
+        pending_f_value.store(inbox.min_parent_f, memory_order_relaxed);
+    }
+
+    PublishedStatistics &published = published_statistics;
+    published.expanded.store(statistics.get_expanded(), memory_order_relaxed);
+    published.evaluated_states.store(
+        statistics.get_evaluated_states(), memory_order_relaxed);
+    published.evaluations.store(
+        statistics.get_evaluations(), memory_order_relaxed);
+    published.generated.store(statistics.get_generated(), memory_order_relaxed);
+    published.reopened.store(statistics.get_reopened(), memory_order_relaxed);
+    published.generated_ops.store(
+        statistics.get_generated_ops(), memory_order_relaxed);
+    published.dead_ends.store(statistics.get_dead_ends(), memory_order_relaxed);
+}
+
+bool ParallelAStarSearch::Worker::is_dead_end(StateID state_id) const {
+    return get_node(state_id).h == INF;
+}
+
+const ParallelSearchNode &ParallelAStarSearch::Worker::get_node(
+    StateID state_id) const {
+    return search_nodes[registry.lookup_state(state_id)];
+}
+
+StateEvaluationContext ParallelAStarSearch::Worker::evaluate(StateID state_id) {
+    StateEvaluationContext eval_context(state_id, registry, &statistics);
+    eval_context.get_evaluator_value_or_infinity(evaluator.get());
+    return eval_context;
+}
+
+
+ParallelAStarSearch::ParallelAStarSearch(
+    const Options &opts, options::Registry &registry,
+    const options::Predefinitions &predefinitions)
+    : SearchEngine(opts),
+      evaluator_config(opts.get<ParseTree>("eval")),
+      registry(registry),
+      predefinitions(predefinitions),
+      num_threads(opts.get<int>("threads")),
+      incumbent_cost(INF),
+      solution_shard(-1),
+      solution_id(StateID::no_state),
+      num_sent_messages(0),
+      num_unprocessed_messages(0),
+      idle(new atomic<bool>[num_threads]),
+      terminated(false),
+      timed_out(false),
+      last_reported_f_value(-1) {
+    /*
+      The axiom evaluator is shared by all registries of the task and
+      successor generation for tasks with axioms is not thread-safe.
+    */
+    task_properties::verify_no_axioms(task_proxy);
+    for (int i = 0; i < num_threads; ++i) {
+        idle[i] = false;
+        state_data_arenas.push_back(create_state_data_arena(opts));
+    }
+}
+
+ParallelAStarSearch::~ParallelAStarSearch() {
+}
+
+int ParallelAStarSearch::get_owner(const PackedStateBin *buffer) const {
+    /*
+      IntHashSet uses the low-order bits of the hash to find the ideal
+      bucket. We use the high-order bits for the shard, so that the states
+      of one shard remain evenly distributed over its buckets.
+    */
+    const int num_hash_bits = 8 * sizeof(StateDataHash);
+    uint64_t high_bits =
+        uint64_t(state_registry.get_state_data_hash(buffer)) >> (num_hash_bits - 32);
+    return static_cast<int>((high_bits * num_threads) >> 32);
+}
+
+void ParallelAStarSearch::report_solution(int shard, StateID id, int cost) {
+    lock_guard<mutex> lock(solution_mutex);
+    if (cost < incumbent_cost) {
+        incumbent_cost = cost;
+        solution_shard = shard;
+        solution_id = id;
+    }
+}
+
+bool ParallelAStarSearch::is_search_space_exhausted() const {
+    long long num_sent_before = num_sent_messages;
+    if (num_unprocessed_messages != 0)
+        return false;
+    for (int i = 0; i < num_threads; ++i) {
+        if (!idle[i])
+            return false;
+    }
+    return num_sent_messages == num_sent_before;
+}
+
+void ParallelAStarSearch::update_statistics() {
+    /*
+      Bring the statistics of the engine up to the sum of the published
+      statistics of the workers. The caller must hold statistics_mutex
+      or be the only running thread.
+    */
+    int expanded = 0;
+    int evaluated_states = 0;
+    int evaluations = 0;
+    int generated = 0;
+    int reopened = 0;
+    int generated_ops = 0;
+    int dead_ends = 0;
+    for (const unique_ptr<Worker> &worker : workers) {
+        const PublishedStatistics &published = worker->get_published_statistics();
+        expanded += published.expanded.load(memory_order_relaxed);
+        evaluated_states += published.evaluated_states.load(memory_order_relaxed);
+        evaluations += published.evaluations.load(memory_order_relaxed);
+        generated += published.generated.load(memory_order_relaxed);
+        reopened += published.reopened.load(memory_order_relaxed);
+        generated_ops += published.generated_ops.load(memory_order_relaxed);
+        dead_ends += published.dead_ends.load(memory_order_relaxed);
+    }
+    statistics.inc_expanded(expanded - statistics.get_expanded());
+    statistics.inc_evaluated_states(
+        evaluated_states - statistics.get_evaluated_states());
+    statistics.inc_evaluations(evaluations - statistics.get_evaluations());
+    statistics.inc_generated(generated - statistics.get_generated());
+    statistics.inc_reopened(reopened - statistics.get_reopened());
+    statistics.inc_generated_ops(generated_ops - statistics.get_generated_ops());
+    statistics.inc_dead_ends(dead_ends - statistics.get_dead_ends());
+}
+
+void ParallelAStarSearch::report_f_value_progress() {
+    /*
+      Workers expand nodes in different f-layers at the same time, so we
+      report the lowest f-value that a worker will expand next. This is
+      approximate: for states in transit between workers, we use the
+      f-values of their parents, which are only lower bounds for
+      consistent heuristics, and the statistics of the other workers can
+      lag behind by one iteration of their loop.
+    */
+    int f = INF;
+    for (const unique_ptr<Worker> &worker : workers) {
+        f = min(f, worker->get_next_f_value());
+    }
+    if (f == INF)
+        return;
+    lock_guard<mutex> lock(statistics_mutex);
+    if (f <= last_reported_f_value)
+        return;
+    last_reported_f_value = f;
+    update_statistics();
+    statistics.report_f_value_progress(f);
+}
+
+void ParallelAStarSearch::run_worker(int id, const utils::CountdownTimer &timer) {
+    Worker &worker = *workers[id];
+    int iteration = 0;
+    while (!terminated) {
+        bool received_messages = worker.process_messages();
+        bool expanded = worker.expand_next_node();
+        worker.flush_outboxes();
+        worker.publish_progress();
+        int next_f = worker.get_next_f_value();
+        if (next_f != INF &&
+            next_f > last_reported_f_value.load(memory_order_relaxed)) {
+            report_f_value_progress();
+        }
+        if (!received_messages && !expanded) {
+            idle[id] = true;
+            if (is_search_space_exhausted()) {
+                terminated = true;
+            } else {
+                this_thread::yield();
+            }
+        }
+        if (++iteration == TIME_CHECK_INTERVAL) {
+            iteration = 0;
+            if (timer.is_expired()) {
+                timed_out = true;
+                terminated = true;
+            }
+        }
+    }
+}
+
+Plan ParallelAStarSearch::extract_plan() const {
+    Plan plan;
+    int shard = solution_shard;
+    StateID id = solution_id;
+    while (true) {
+        const ParallelSearchNode &node = workers[shard]->get_node(id);
+        if (node.creating_operator == OperatorID::no_operator) {
+            assert(node.parent_id == StateID::no_state);
+            break;
+        }
+        plan.push_back(node.creating_operator);
+        shard = node.parent_shard;
+        id = node.parent_id;
+    }
+    reverse(plan.begin(), plan.end());
+    return plan;
+}
+
+void ParallelAStarSearch::initialize() {
+    utils::g_log << "Conducting hash-distributed parallel A* search with "
+                 << num_threads << " thread(s), (real) bound = " << bound
+                 << endl;
+
+    /*
+      Evaluators are created sequentially because their construction
+      accesses shared data structures such as the log.
+    */
+    set<Evaluator *> distinct_evaluators;
+    for (int i = 0; i < num_threads; ++i) {
+        OptionParser parser(evaluator_config, registry, predefinitions, false);
+        shared_ptr<Evaluator> evaluator =
+            parser.start_parsing<shared_ptr<Evaluator>>();
+        set<Evaluator *> path_dependent_evaluators;
+        evaluator->get_path_dependent_evaluators(path_dependent_evaluators);
+        if (!path_dependent_evaluators.empty()) {
+            cerr << "parallel_astar does not support path-dependent evaluators."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+        }
+        if (!distinct_evaluators.insert(evaluator.get()).second) {
+            cerr << "parallel_astar needs a separate evaluator for each "
+                 << "thread. Please do not use predefined evaluators."
+                 << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+        }
+        workers.push_back(utils::make_unique_ptr<Worker>(
+            *this, i, evaluator, state_data_arenas[i]));
+    }
+
+    const State &initial_state = state_registry.get_initial_state();
+    int owner = get_owner(initial_state.get_buffer());
+    Worker &worker = *workers[owner];
+    StateID initial_id = worker.insert_initial_state(initial_state);
+
+    // The evaluator caches its estimate, so this does not evaluate again.
+    StateEvaluationContext eval_context = worker.evaluate(initial_id);
+    if (worker.is_dead_end(initial_id)) {
+        utils::g_log << "Initial state is a dead end." << endl;
+    }
+    print_initial_evaluator_values(eval_context);
+}
+
+SearchStatus ParallelAStarSearch::step() {
+    utils::CountdownTimer timer(max_time);
+    vector<thread> threads;
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(&ParallelAStarSearch::run_worker, this, i, cref(timer));
+    }
+    for (thread &t : threads) {
+        t.join();
+    }
+
+    for (const unique_ptr<Worker> &worker : workers) {
+        worker->publish_progress();
+    }
+    update_statistics();
+
+    if (solution_shard != -1) {
+        utils::g_log << "Solution found!" << endl;
+        set_plan(extract_plan());
+        return SOLVED;
+    } else if (timed_out) {
+        return TIMEOUT;
+    }
+    utils::g_log << "Completely explored state space -- no solution!" << endl;
+    return FAILED;
+}
+
+void ParallelAStarSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    size_t num_registered_states = 0;
+    for (const unique_ptr<Worker> &worker : workers) {
+        num_registered_states += worker->get_registry().size();
+    }
+    utils::g_log << "Number of registered states: "
+                 << num_registered_states << endl;
+    if (state_data_arenas.front()) {
+        size_t num_file_backed_bytes = 0;
+        for (const shared_ptr<utils::FileBackedArena> &arena : state_data_arenas) {
+            num_file_backed_bytes += arena->get_allocated_bytes();
+        }
+        utils::g_log << "File-backed state data: "
+                     << num_file_backed_bytes / 1024 << " KB" << endl;
+    }
+    utils::g_log << "Expanded states per thread:";
+    for (const unique_ptr<Worker> &worker : workers) {
+        utils::g_log << " " << worker->get_statistics().get_expanded();
+    }
+    utils::g_log << endl;
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Parallel A* search",
+        "Hash-distributed A* (HDA*) with one worker thread per shard of the "
+        "state space. Every worker owns the states whose hash falls into its "
+        "shard and evaluates them with its own copy of the evaluator. "
+        "For admissible evaluators, the search returns optimal plans.");
+    parser.document_note(
+        "Evaluators",
+        "Each thread parses its own instance of the evaluator, so "
+        "preprocessing (e.g. PDB construction) is repeated once per thread. "
+        "Predefined evaluators cannot be used because they would be shared "
+        "between threads. Path-dependent evaluators are not supported.");
+    parser.document_language_support("action costs", "supported");
+    parser.document_language_support("conditional effects", "supported");
+    parser.document_language_support("axioms", "not supported");
+    parser.add_option<ParseTree>("eval", "evaluator for h-value");
+    parser.add_option<int>(
+        "threads",
+        "number of worker threads",
+        "1",
+        Bounds("1", "infinity"));
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.help_mode()) {
+        return nullptr;
+    } else if (parser.dry_run()) {
+        // Check if the supplied evaluator can be parsed.
+        OptionParser test_parser(opts.get<ParseTree>("eval"),
+                                 parser.get_registry(),
+                                 parser.get_predefinitions(), true);
+        test_parser.start_parsing<shared_ptr<Evaluator>>();
+        return nullptr;
+    } else {
+        return make_shared<ParallelAStarSearch>(
+            opts, parser.get_registry(), parser.get_predefinitions());
+    }
+}
+
+static Plugin<SearchEngine> _plugin("parallel_astar", _parse);
+}
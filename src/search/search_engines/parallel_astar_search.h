@@ -0,0 +1,103 @@
+#ifndef SEARCH_ENGINES_PARALLEL_ASTAR_SEARCH_H
+#define SEARCH_ENGINES_PARALLEL_ASTAR_SEARCH_H
+
+#include "../search_engine.h"
+
+#include "../options/parse_tree.h"
+#include "../options/predefinitions.h"
+#include "../options/registries.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace options {
+class Options;
+}
+
+namespace utils {
+class CountdownTimer;
+class FileBackedArena;
+}
+
+namespace parallel_astar_search {
+/*
+  Hash-distributed parallel A* (HDA*, Kishimoto, Fukunaga and Botea, 2009).
+
+  Every worker thread owns a shard of the state space: its own
+  StateRegistry, open list, search nodes and evaluator. A state belongs
+  to the shard determined by the hash of its packed data (the same hash
+  the registry uses for duplicate detection), so duplicate detection
+  never needs to look at other shards. Successors owned by other shards
+  are sent to their owner in batches.
+
+  The incumbent solution cost is shared between the workers. The search
+  terminates once no worker has an open node with an f-value below the
+  incumbent cost and no messages are in transit, which guarantees
+  optimal plans for admissible heuristics.
+*/
+class ParallelAStarSearch : public SearchEngine {
+    class Worker;
+
+    /*
+      Every worker parses its own evaluator from this configuration because
+      evaluators are not thread-safe. As in IteratedSearch, we copy the
+      registry and predefinitions needed for parsing.
+    */
+    const options::ParseTree evaluator_config;
+    options::Registry registry;
+    options::Predefinitions predefinitions;
+    const int num_threads;
+    /* Arenas are not thread-safe, so with state_storage=disk every
+       worker's registry gets its own arena (and file). */
+    std::vector<std::shared_ptr<utils::FileBackedArena>> state_data_arenas;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    /* Cost of the best solution found so far or infinity. Workers do not
+       expand nodes whose f-value is not below this cost. */
+    std::atomic<int> incumbent_cost;
+    std::mutex solution_mutex;
+    int solution_shard;
+    StateID solution_id;
+
+    /* Termination detection: a worker may only become busy again after
+       receiving a message, so the search space is exhausted if all workers
+       are idle, no message is unprocessed and no message was sent while we
+       checked the idle flags. */
+    std::atomic<long long> num_sent_messages;
+    std::atomic<long long> num_unprocessed_messages;
+    std::unique_ptr<std::atomic<bool>[]> idle;
+    std::atomic<bool> terminated;
+    std::atomic<bool> timed_out;
+
+    /* Highest f-value reported so far. Workers call
+       report_f_value_progress when their next node has a higher f-value,
+       which merges the current statistics of all workers. */
+    std::atomic<int> last_reported_f_value;
+    std::mutex statistics_mutex;
+
+    int get_owner(const PackedStateBin *buffer) const;
+    void report_solution(int shard, StateID id, int cost);
+    bool is_search_space_exhausted() const;
+    void update_statistics();
+    void report_f_value_progress();
+    void run_worker(int id, const utils::CountdownTimer &timer);
+    Plan extract_plan() const;
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    ParallelAStarSearch(
+        const options::Options &opts, options::Registry &registry,
+        const options::Predefinitions &predefinitions);
+    virtual ~ParallelAStarSearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -1,5 +1,12 @@
 #include "search_node_info.h"
 
+#ifdef USE_64_BIT_STATE_IDS
+// The 64-bit parent state ID forces 4 bytes of padding.
+static_assert(
+    sizeof(SearchNodeInfo) == 2 * sizeof(StateID),
+    "SearchNodeInfo has unexpected size.");
+#else
 static_assert(
     sizeof(SearchNodeInfo) == sizeof(StateID) + sizeof(int),
     "SearchNodeInfo has unexpected size.");
+#endif
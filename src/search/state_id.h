@@ -1,12 +1,27 @@
 #ifndef STATE_ID_H
 #define STATE_ID_H
 
+#include <cstdint>
 #include <iostream>
 
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
 class StateID {
+public:
+    /*
+      By default, state IDs and the hash set of registered states use
+      32-bit integers, which limits a registry to 2^31 - 1 states. Building
+      with the CMake option USE_64_BIT_STATE_IDS lifts this limit at the
+      cost of 8 additional bytes per entry of the hash set.
+    */
+#ifdef USE_64_BIT_STATE_IDS
+    using ValueType = std::int64_t;
+#else
+    using ValueType = int;
+#endif
+
+private:
     friend class StateRegistry;
     friend std::ostream &operator<<(std::ostream &os, StateID id);
     template<typename>
@@ -15,8 +30,8 @@ class StateID {
     friend class PerStateArray;
     friend class PerStateBitset;
 
-    int value;
-    explicit StateID(int value_)
+    ValueType value;
+    explicit StateID(ValueType value_)
         : value(value_) {
     }
 
@@ -35,6 +50,10 @@ public:
     bool operator!=(const StateID &other) const {
         return !(*this == other);
     }
+
+    bool operator<(const StateID &other) const {
+        return value < other.value;
+    }
 };
 
 
@@ -8,12 +8,29 @@
 
 using namespace std;
 
-StateRegistry::StateRegistry(const TaskProxy &task_proxy)
+static vector<int> get_derived_variables(const TaskProxy &task_proxy) {
+    vector<int> derived_variables;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        if (var.is_derived()) {
+            derived_variables.push_back(var.get_id());
+        }
+    }
+    return derived_variables;
+}
+
+StateRegistry::StateRegistry(
+    const TaskProxy &task_proxy,
+    const shared_ptr<utils::FileBackedArena> &state_data_arena)
     : task_proxy(task_proxy),
       state_packer(task_properties::g_state_packers[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
       num_variables(task_proxy.get_variables().size()),
-      state_data_pool(get_bins_per_state()),
+      effect_programs(task_proxy, state_packer),
+      derived_variables(get_derived_variables(task_proxy)),
+      state_data_arena(state_data_arena),
+      state_data_pool(
+          get_bins_per_state(),
+          utils::ArenaAllocator<PackedStateBin>(state_data_arena.get())),
       registered_states(
           StateIDSemanticHash(state_data_pool, get_bins_per_state()),
           StateIDSemanticEqual(state_data_pool, get_bins_per_state())) {
@@ -27,12 +44,13 @@ StateID StateRegistry::insert_id_or_pop_state() {
       state data pool.
     */
     StateID id(state_data_pool.size() - 1);
-    pair<int, bool> result = registered_states.insert(id.value);
+    pair<StateID::ValueType, bool> result = registered_states.insert(id.value);
     bool is_new_entry = result.second;
     if (!is_new_entry) {
         state_data_pool.pop_back();
     }
-    assert(registered_states.size() == static_cast<int>(state_data_pool.size()));
+    assert(registered_states.size() ==
+           static_cast<StateID::ValueType>(state_data_pool.size()));
     return StateID(result.first);
 }
 
@@ -66,35 +84,45 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
     assert(!op.is_axiom());
     state_data_pool.push_back(predecessor.get_buffer());
     PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
-    /* Experiments for issue348 showed that for tasks with axioms it's faster
-       to compute successor states using unpacked data. */
+    effect_programs.apply(op.get_id(), predecessor.get_buffer(), buffer);
     if (task_properties::has_axioms(task_proxy)) {
+        /* Experiments for issue348 showed that for tasks with axioms it's
+           faster to evaluate the axioms on unpacked data. Only the derived
+           variables need to be packed again afterwards. */
         predecessor.unpack();
-        vector<int> new_values = predecessor.get_unpacked_values();
-        for (EffectProxy effect : op.get_effects()) {
-            if (does_fire(effect, predecessor)) {
-                FactPair effect_pair = effect.get_fact().get_pair();
-                new_values[effect_pair.var] = effect_pair.value;
-            }
-        }
+        const vector<int> &predecessor_values = predecessor.get_unpacked_values();
+        vector<int> new_values = predecessor_values;
+        effect_programs.apply(op.get_id(), predecessor_values, new_values);
         axiom_evaluator.evaluate(new_values);
-        for (size_t i = 0; i < new_values.size(); ++i) {
-            state_packer.set(buffer, i, new_values[i]);
+        for (int var : derived_variables) {
+            state_packer.set(buffer, var, new_values[var]);
         }
         StateID id = insert_id_or_pop_state();
-        return task_proxy.create_state(*this, id, buffer, move(new_values));
+        return task_proxy.create_state(
+            *this, id, state_data_pool[id.value], move(new_values));
     } else {
-        for (EffectProxy effect : op.get_effects()) {
-            if (does_fire(effect, predecessor)) {
-                FactPair effect_pair = effect.get_fact().get_pair();
-                state_packer.set(buffer, effect_pair.var, effect_pair.value);
-            }
-        }
+        /* For duplicates, buffer has been popped from the pool and will be
+           overwritten by the next state, so we must refer to the stored data. */
         StateID id = insert_id_or_pop_state();
-        return task_proxy.create_state(*this, id, buffer);
+        return lookup_state(id);
     }
 }
 
+void StateRegistry::compute_successor_data(
+    const State &predecessor, const OperatorProxy &op,
+    PackedStateBin *buffer) const {
+    assert(!op.is_axiom());
+    assert(!task_properties::has_axioms(task_proxy));
+    copy_n(predecessor.get_buffer(), get_bins_per_state(), buffer);
+    effect_programs.apply(op.get_id(), predecessor.get_buffer(), buffer);
+}
+
+State StateRegistry::register_state_data(const PackedStateBin *buffer) {
+    state_data_pool.push_back(buffer);
+    StateID id = insert_id_or_pop_state();
+    return lookup_state(id);
+}
+
 int StateRegistry::get_bins_per_state() const {
     return state_packer.get_num_bins();
 }
@@ -105,5 +133,12 @@ int StateRegistry::get_state_size_in_bytes() const {
 
 void StateRegistry::print_statistics() const {
     utils::g_log << "Number of registered states: " << size() << endl;
+    utils::g_log << "Bytes per registered state: " << get_state_size_in_bytes()
+                 << endl;
     registered_states.print_statistics();
+    if (state_data_arena) {
+        utils::g_log << "File-backed state data: "
+                     << state_data_arena->get_allocated_bytes() / 1024 << " KB"
+                     << endl;
+    }
 }
@@ -3,12 +3,14 @@
 
 #include "abstract_task.h"
 #include "axioms.h"
+#include "effect_programs.h"
 #include "state_id.h"
 
 #include "algorithms/int_hash_set.h"
 #include "algorithms/int_packer.h"
 #include "algorithms/segmented_vector.h"
 #include "algorithms/subscriber.h"
+#include "utils/file_backed_arena.h"
 #include "utils/hash.h"
 
 #include <set>
@@ -111,39 +113,62 @@ class IntPacker;
 
 using PackedStateBin = int_packer::IntPacker::Bin;
 
+/*
+  Hash values used for duplicate detection. They must be at least as wide
+  as state IDs so that the hash set of registered states can address all
+  of its buckets (see StateID::ValueType).
+*/
+#ifdef USE_64_BIT_STATE_IDS
+using StateDataHash = std::uint64_t;
+#else
+using StateDataHash = int_hash_set::HashType;
+#endif
+
+
+inline StateDataHash hash_state_data(
+    const PackedStateBin *data, int state_size) {
+    utils::HashState hash_state;
+    for (int i = 0; i < state_size; ++i) {
+        hash_state.feed(data[i]);
+    }
+#ifdef USE_64_BIT_STATE_IDS
+    return hash_state.get_hash64();
+#else
+    return hash_state.get_hash32();
+#endif
+}
+
 
 class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
+    using StateDataPool = segmented_vector::SegmentedArrayVector<
+        PackedStateBin, utils::ArenaAllocator<PackedStateBin>>;
+
     struct StateIDSemanticHash {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateDataPool &state_data_pool;
         int state_size;
         StateIDSemanticHash(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
+            const StateDataPool &state_data_pool,
             int state_size)
             : state_data_pool(state_data_pool),
               state_size(state_size) {
         }
 
-        int_hash_set::HashType operator()(int id) const {
-            const PackedStateBin *data = state_data_pool[id];
-            utils::HashState hash_state;
-            for (int i = 0; i < state_size; ++i) {
-                hash_state.feed(data[i]);
-            }
-            return hash_state.get_hash32();
+        StateDataHash operator()(StateID::ValueType id) const {
+            return hash_state_data(state_data_pool[id], state_size);
         }
     };
 
     struct StateIDSemanticEqual {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateDataPool &state_data_pool;
         int state_size;
         StateIDSemanticEqual(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
+            const StateDataPool &state_data_pool,
             int state_size)
             : state_data_pool(state_data_pool),
               state_size(state_size) {
         }
 
-        bool operator()(int lhs, int rhs) const {
+        bool operator()(StateID::ValueType lhs, StateID::ValueType rhs) const {
             const PackedStateBin *lhs_data = state_data_pool[lhs];
             const PackedStateBin *rhs_data = state_data_pool[rhs];
             return std::equal(lhs_data, lhs_data + state_size, rhs_data);
@@ -155,22 +180,31 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
       this registry and find their IDs. States are compared/hashed semantically,
       i.e. the actual state data is compared, not the memory location.
     */
-    using StateIDSet = int_hash_set::IntHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
+    using StateIDSet = int_hash_set::IntHashSet<
+        StateIDSemanticHash, StateIDSemanticEqual,
+        StateID::ValueType, StateDataHash>;
 
     TaskProxy task_proxy;
     const int_packer::IntPacker &state_packer;
     AxiomEvaluator &axiom_evaluator;
     const int num_variables;
-
-    segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    const EffectPrograms effect_programs;
+    // IDs of all derived variables (empty if the task has no axioms).
+    const std::vector<int> derived_variables;
+
+    /* If set, the packed state data lives in memory that is backed by a
+       file on disk (see FileBackedArena) instead of the heap. */
+    std::shared_ptr<utils::FileBackedArena> state_data_arena;
+    StateDataPool state_data_pool;
     StateIDSet registered_states;
 
     std::unique_ptr<State> cached_initial_state;
 
     StateID insert_id_or_pop_state();
-    int get_bins_per_state() const;
 public:
-    explicit StateRegistry(const TaskProxy &task_proxy);
+    explicit StateRegistry(
+        const TaskProxy &task_proxy,
+        const std::shared_ptr<utils::FileBackedArena> &state_data_arena = nullptr);
 
     const TaskProxy &get_task_proxy() const {
         return task_proxy;
@@ -203,6 +237,33 @@ public:
     */
     State get_successor_state(const State &predecessor, const OperatorProxy &op);
 
+    /*
+      Writes the packed data of the state that results from applying op to
+      predecessor into buffer, which must have room for get_bins_per_state()
+      bins. The successor is *not* registered. This is useful for sharded
+      registries where the registry owning the successor is only known after
+      its data has been computed (see register_state_data). Only supported for
+      tasks without axioms.
+    */
+    void compute_successor_data(
+        const State &predecessor, const OperatorProxy &op,
+        PackedStateBin *buffer) const;
+
+    /*
+      Registers the state with the given packed data if this was not done
+      before and returns it. The data must have been created with the state
+      packer of this registry's task.
+    */
+    State register_state_data(const PackedStateBin *buffer);
+
+    /*
+      Returns the hash value that is used for duplicate detection of the
+      state with the given packed data.
+    */
+    StateDataHash get_state_data_hash(const PackedStateBin *buffer) const {
+        return hash_state_data(buffer, get_bins_per_state());
+    }
+
     /*
       Returns the number of states registered so far.
     */
@@ -210,6 +271,7 @@ public:
         return registered_states.size();
     }
 
+    int get_bins_per_state() const;
     int get_state_size_in_bytes() const;
 
     void print_statistics() const;
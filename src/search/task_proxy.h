@@ -724,6 +724,15 @@ public:
         return create_state(std::move(state_values));
     }
 
+    /*
+      Return true iff convert_ancestor_state returns a state with the same
+      values as the given ancestor state.
+    */
+    bool keeps_ancestor_state_values(const State &ancestor_state) const {
+        return task->keeps_ancestor_state_values(
+            ancestor_state.get_task().task);
+    }
+
     const causal_graph::CausalGraph &get_causal_graph() const;
 };
 
@@ -108,4 +108,13 @@ void DelegatingTask::convert_ancestor_state_values(
     parent->convert_ancestor_state_values(values, ancestor_task);
     convert_state_values_from_parent(values);
 }
+
+bool DelegatingTask::keeps_ancestor_state_values(
+    const AbstractTask *ancestor_task) const {
+    if (this == ancestor_task) {
+        return true;
+    }
+    return keeps_state_values_from_parent() &&
+           parent->keeps_ancestor_state_values(ancestor_task);
+}
 }
@@ -61,6 +61,13 @@ public:
         const AbstractTask *ancestor_task) const final override;
     virtual void convert_state_values_from_parent(std::vector<int> &) const {
     }
+
+    virtual bool keeps_ancestor_state_values(
+        const AbstractTask *ancestor_task) const final override;
+    // Subclasses that override convert_state_values_from_parent must return false.
+    virtual bool keeps_state_values_from_parent() const {
+        return true;
+    }
 };
 }
 
@@ -106,6 +106,8 @@ public:
     virtual void convert_ancestor_state_values(
         vector<int> &values,
         const AbstractTask *ancestor_task) const override;
+    virtual bool keeps_ancestor_state_values(
+        const AbstractTask *ancestor_task) const override;
 };
 
 
@@ -497,6 +499,11 @@ void RootTask::convert_ancestor_state_values(
     }
 }
 
+bool RootTask::keeps_ancestor_state_values(
+    const AbstractTask *ancestor_task) const {
+    return this == ancestor_task;
+}
+
 void read_root_task(istream &in) {
     assert(!g_root_task);
     g_root_task = make_shared<RootTask>(in);
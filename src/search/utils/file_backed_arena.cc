@@ -0,0 +1,110 @@
+#include "file_backed_arena.h"
+
+#include "logging.h"
+#include "system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace utils {
+// Alignment of all allocations (enough for all fundamental types).
+static const size_t ALIGNMENT = alignof(max_align_t);
+
+static size_t round_up(size_t num_bytes, size_t multiple) {
+    return (num_bytes + multiple - 1) / multiple * multiple;
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+NO_RETURN static void exit_with_system_error(const string &what) {
+    cerr << "File-backed arena: " << what << " failed: "
+         << strerror(errno) << endl;
+    exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+}
+
+FileBackedArena::FileBackedArena(const string &directory)
+    : file_descriptor(-1),
+      file_size(0),
+      next_free(nullptr),
+      num_free_bytes(0),
+      num_allocated_bytes(0) {
+    string path_template = directory + "/downward-arena-XXXXXX";
+    vector<char> path(path_template.begin(), path_template.end());
+    path.push_back('\0');
+    file_descriptor = mkstemp(path.data());
+    if (file_descriptor == -1) {
+        exit_with_system_error("creating a temporary file in " + directory);
+    }
+    // Remove the directory entry, so the file disappears when we close it.
+    if (unlink(path.data()) == -1) {
+        exit_with_system_error("unlinking " + string(path.data()));
+    }
+    g_log << "Using file-backed memory in " << directory << endl;
+}
+
+FileBackedArena::~FileBackedArena() {
+    for (const pair<char *, size_t> &chunk : chunks) {
+        munmap(chunk.first, chunk.second);
+    }
+    close(file_descriptor);
+}
+
+void FileBackedArena::add_chunk(size_t min_bytes) {
+    size_t chunk_size = round_up(max(min_bytes, CHUNK_BYTES), sysconf(_SC_PAGESIZE));
+    if (ftruncate(file_descriptor, file_size + chunk_size) == -1) {
+        exit_with_system_error("growing the arena file");
+    }
+    void *chunk = mmap(nullptr, chunk_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       file_descriptor, file_size);
+    if (chunk == MAP_FAILED) {
+        exit_with_system_error("mapping the arena file");
+    }
+    file_size += chunk_size;
+    chunks.emplace_back(static_cast<char *>(chunk), chunk_size);
+    next_free = static_cast<char *>(chunk);
+    num_free_bytes = chunk_size;
+}
+#else
+FileBackedArena::FileBackedArena(const string &)
+    : file_descriptor(-1),
+      file_size(0),
+      next_free(nullptr),
+      num_free_bytes(0),
+      num_allocated_bytes(0) {
+    cerr << "File-backed memory is not supported on this operating system."
+         << endl;
+    exit_with(ExitCode::SEARCH_UNSUPPORTED);
+}
+
+FileBackedArena::~FileBackedArena() {
+}
+
+void FileBackedArena::add_chunk(size_t) {
+    ABORT("File-backed memory is not supported on this operating system.");
+}
+#endif
+
+void *FileBackedArena::allocate(size_t num_bytes) {
+    num_bytes = round_up(max(num_bytes, size_t(1)), ALIGNMENT);
+    if (num_bytes > num_free_bytes) {
+        add_chunk(num_bytes);
+    }
+    assert(num_bytes <= num_free_bytes);
+    void *result = next_free;
+    next_free += num_bytes;
+    num_free_bytes -= num_bytes;
+    num_allocated_bytes += num_bytes;
+    return result;
+}
+}
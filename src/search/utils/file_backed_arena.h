@@ -0,0 +1,126 @@
+#ifndef UTILS_FILE_BACKED_ARENA_H
+#define UTILS_FILE_BACKED_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utils {
+/*
+  Memory arena whose pages are backed by a file on local disk instead of
+  anonymous memory.
+
+  Memory is handed out from large chunks that are memory-mapped from a
+  temporary file in the given directory. The operating system writes
+  dirty pages back to the file and may evict pages that have not been
+  touched recently, so data that is rarely accessed (e.g., the packed
+  data of states that were expanded long ago) does not need to fit into
+  physical memory. Accessing an evicted page reads it back from disk,
+  which is slow, so this only pays off if accesses have some locality.
+
+  The file is deleted as soon as it is created, so the operating system
+  reclaims the disk space when the arena is destroyed or the process
+  ends. Individual allocations cannot be freed.
+
+  File-backed arenas are only supported on Linux and macOS.
+*/
+class FileBackedArena {
+    // Size of the chunks that we map from the file.
+    static const std::size_t CHUNK_BYTES = 64 * 1024 * 1024;
+
+    int file_descriptor;
+    std::size_t file_size;
+    std::vector<std::pair<char *, std::size_t>> chunks;
+    char *next_free;
+    std::size_t num_free_bytes;
+    std::size_t num_allocated_bytes;
+
+    void add_chunk(std::size_t min_bytes);
+public:
+    explicit FileBackedArena(const std::string &directory);
+    ~FileBackedArena();
+
+    FileBackedArena(const FileBackedArena &) = delete;
+    FileBackedArena &operator=(const FileBackedArena &) = delete;
+
+    void *allocate(std::size_t num_bytes);
+
+    std::size_t get_allocated_bytes() const {
+        return num_allocated_bytes;
+    }
+
+    std::size_t get_file_size() const {
+        return file_size;
+    }
+};
+
+
+/*
+  Allocator for containers such as SegmentedArrayVector that allocates
+  from a FileBackedArena or, if no arena is given, from the heap. The
+  arena must outlive all containers using it.
+*/
+template<typename T>
+class ArenaAllocator {
+    template<typename>
+    friend class ArenaAllocator;
+
+    FileBackedArena *arena;
+    std::allocator<T> heap_allocator;
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = ArenaAllocator<U>;
+    };
+
+    explicit ArenaAllocator(FileBackedArena *arena = nullptr)
+        : arena(arena) {
+    }
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other)
+        : arena(other.arena) {
+    }
+
+    T *allocate(std::size_t n) {
+        if (arena) {
+            return static_cast<T *>(arena->allocate(n * sizeof(T)));
+        }
+        return heap_allocator.allocate(n);
+    }
+
+    void deallocate(T *p, std::size_t n) {
+        // Memory from the arena is released when the arena is destroyed.
+        if (!arena) {
+            heap_allocator.deallocate(p, n);
+        }
+    }
+
+    template<typename U, typename ... Args>
+    void construct(U *p, Args && ... args) {
+        ::new(static_cast<void *>(p))U(std::forward<Args>(args) ...);
+    }
+
+    template<typename U>
+    void destroy(U *p) {
+        p->~U();
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U> &other) const {
+        return arena == other.arena;
+    }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const {
+        return !(*this == other);
+    }
+};
+}
+
+#endif
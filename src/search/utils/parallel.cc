@@ -0,0 +1,40 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+void parallel_for(
+    int num_tasks, int num_threads, const function<void(int)> &task) {
+    assert(num_threads >= 1);
+    num_threads = min(num_threads, num_tasks);
+    if (num_threads <= 1) {
+        for (int i = 0; i < num_tasks; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    atomic<int> next_task(0);
+    auto run_tasks = [&]() {
+            int i;
+            while ((i = next_task++) < num_tasks) {
+                task(i);
+            }
+        };
+    vector<thread> threads;
+    threads.reserve(num_threads - 1);
+    for (int i = 1; i < num_threads; ++i) {
+        threads.emplace_back(run_tasks);
+    }
+    run_tasks();
+    for (thread &t : threads) {
+        t.join();
+    }
+}
+}
@@ -0,0 +1,20 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <functional>
+
+namespace utils {
+/*
+  Call task(i) for all i in {0, ..., num_tasks - 1}, using up to
+  num_threads threads (including the calling thread). Tasks are started
+  in order of increasing index but may finish in any order, so they
+  should only write to memory reserved for their index. With
+  num_threads = 1, all tasks run in the calling thread in order.
+
+  The tasks must not throw exceptions.
+*/
+extern void parallel_for(
+    int num_tasks, int num_threads, const std::function<void(int)> &task);
+}
+
+#endif